@@ -0,0 +1,118 @@
+// Nonius - C++ benchmarking tool
+//
+// Written in 2014- by the nonius contributors <nonius@rmf.io>
+//
+// To the extent possible under law, the author(s) have dedicated all copyright and related
+// and neighboring rights to this software to the public domain worldwide. This software is
+// distributed without any warranty.
+//
+// You should have received a copy of the CC0 Public Domain Dedication along with this software.
+// If not, see <http://creativecommons.org/publicdomain/zero/1.0/>
+
+// Allocation tracking
+
+#ifndef NONIUS_ALLOCATION_HPP
+#define NONIUS_ALLOCATION_HPP
+
+#include <nonius/chronometer.h++>
+#include <nonius/detail/allocation_counters.h++>
+#include <nonius/detail/meta.h++>
+#include <nonius/detail/noexcept.h++>
+#include <nonius/detail/unique_name.h++>
+
+#include <string>
+#include <exception>
+#include <type_traits>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace nonius {
+    struct allocation_error : virtual std::exception {
+        explicit allocation_error(std::uint64_t calls)
+        : message("benchmark performed " + std::to_string(calls) + " allocations while being measured") {}
+
+        char const* what() const NONIUS_NOEXCEPT override {
+            return message.c_str();
+        }
+
+        std::string message;
+    };
+
+    struct allocation_tracking_disabled : virtual std::exception {
+        char const* what() const NONIUS_NOEXCEPT override {
+            return "allocation tracking is not enabled; #define NONIUS_TRACK_ALLOCATIONS in one file";
+        }
+    };
+
+    namespace detail {
+        template <typename Fun>
+        struct allocation_free_fn {
+            void operator()(chronometer meter) const {
+                if(!allocation_tracking_enabled()) throw allocation_tracking_disabled();
+                auto before = global_allocation_counters().calls.load();
+                call(meter, is_callable<Fun const&(chronometer)>());
+                auto after = global_allocation_counters().calls.load();
+                if(after != before) throw allocation_error(after - before);
+            }
+
+            void call(chronometer meter, std::true_type) const { fun(meter); }
+            void call(chronometer meter, std::false_type) const { meter.measure(fun); }
+
+            Fun fun;
+        };
+
+        // Every block carries its size in a header so that unsized deallocation can be accounted for.
+        const std::size_t allocation_header_size = alignof(std::max_align_t) > sizeof(std::size_t) ? alignof(std::max_align_t) : sizeof(std::size_t);
+
+        inline void* tracked_allocate(std::size_t size) NONIUS_NOEXCEPT {
+            auto base = static_cast<char*>(std::malloc(size + allocation_header_size));
+            if(!base) return nullptr;
+            *reinterpret_cast<std::size_t*>(base) = size;
+            record_allocation(size);
+            return base + allocation_header_size;
+        }
+        inline void tracked_deallocate(void* p) NONIUS_NOEXCEPT {
+            if(!p) return;
+            auto base = static_cast<char*>(p) - allocation_header_size;
+            record_deallocation(*reinterpret_cast<std::size_t*>(base));
+            std::free(base);
+        }
+        inline void* tracked_new(std::size_t size) {
+            for(;;) {
+                if(auto p = tracked_allocate(size)) return p;
+                auto handler = std::get_new_handler();
+                if(!handler) throw std::bad_alloc();
+                handler();
+            }
+        }
+    } // namespace detail
+
+    template <typename Fun>
+    detail::allocation_free_fn<typename std::decay<Fun>::type> allocation_free(Fun&& fun) {
+        return { std::forward<Fun>(fun) };
+    }
+} // namespace nonius
+
+#ifdef NONIUS_TRACK_ALLOCATIONS
+void* operator new(std::size_t size) { return ::nonius::detail::tracked_new(size); }
+void* operator new[](std::size_t size) { return ::nonius::detail::tracked_new(size); }
+void* operator new(std::size_t size, std::nothrow_t const&) NONIUS_NOEXCEPT { return ::nonius::detail::tracked_allocate(size); }
+void* operator new[](std::size_t size, std::nothrow_t const&) NONIUS_NOEXCEPT { return ::nonius::detail::tracked_allocate(size); }
+void operator delete(void* p) NONIUS_NOEXCEPT { ::nonius::detail::tracked_deallocate(p); }
+void operator delete[](void* p) NONIUS_NOEXCEPT { ::nonius::detail::tracked_deallocate(p); }
+void operator delete(void* p, std::nothrow_t const&) NONIUS_NOEXCEPT { ::nonius::detail::tracked_deallocate(p); }
+void operator delete[](void* p, std::nothrow_t const&) NONIUS_NOEXCEPT { ::nonius::detail::tracked_deallocate(p); }
+#ifdef __cpp_sized_deallocation
+void operator delete(void* p, std::size_t) NONIUS_NOEXCEPT { ::nonius::detail::tracked_deallocate(p); }
+void operator delete[](void* p, std::size_t) NONIUS_NOEXCEPT { ::nonius::detail::tracked_deallocate(p); }
+#endif // __cpp_sized_deallocation
+
+namespace {
+    static bool const NONIUS_DETAIL_UNIQUE_NAME(allocation_tracking) = (::nonius::detail::global_allocation_counters().enabled = true);
+}
+#endif // NONIUS_TRACK_ALLOCATIONS
+
+#endif // NONIUS_ALLOCATION_HPP
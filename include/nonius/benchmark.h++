@@ -27,6 +27,7 @@
 #include <nonius/detail/unique_name.h++>
 
 #include <algorithm>
+#include <iterator>
 #include <string>
 #include <vector>
 #include <utility>
@@ -34,7 +35,6 @@
 
 namespace nonius {
     namespace detail {
-        const auto warmup_iterations = 10000;
         const auto warmup_time = chrono::milliseconds(100);
         const auto minimum_ticks = 1000;
     } // namespace detail
@@ -50,11 +50,42 @@ namespace nonius {
             auto run_time = std::max(min_time, chrono::duration_cast<decltype(min_time)>(detail::warmup_time));
             auto&& test = detail::run_for_at_least<Clock>(params, chrono::duration_cast<Duration<Clock>>(run_time), 1, bench);
             int new_iters = static_cast<int>(std::ceil(min_time * test.iterations / test.elapsed));
-            return { new_iters, test.elapsed / test.iterations * new_iters * cfg.samples, params, bench, chrono::duration_cast<FloatDuration<Clock>>(detail::warmup_time), detail::warmup_iterations };
+            return make_plan<Clock>(cfg, std::move(params), std::move(bench), new_iters, FloatDuration<Clock>(test.elapsed) / test.iterations);
+        }
+
+        // Prepares with an iteration count known from a previous run, skipping the estimation.
+        template <typename Clock>
+        execution_plan<FloatDuration<Clock>> prepare(configuration cfg, parameters params, int iterations, FloatDuration<Clock> iteration_time) const {
+            auto bench = fun(params);
+            return make_plan<Clock>(cfg, std::move(params), std::move(bench), iterations, iteration_time);
+        }
+
+        // Times the first few runs individually, before anything else has had a chance to warm up.
+        template <typename Clock>
+        std::vector<FloatDuration<Clock>> first_calls(configuration cfg, parameters params, environment<FloatDuration<Clock>> env) const {
+            auto bench = fun(params);
+            std::vector<FloatDuration<Clock>> times;
+            times.reserve(cfg.first_calls);
+            std::generate_n(std::back_inserter(times), cfg.first_calls, [&]{
+                detail::chronometer_model<Clock> model;
+                detail::optimizer_barrier();
+                bench(chronometer(model, 1, params));
+                detail::optimizer_barrier();
+                auto time = model.elapsed() - detail::measurement_overhead(model, env);
+                return std::max(time, FloatDuration<Clock>::zero());
+            });
+            return times;
         }
 
         std::string name;
         detail::benchmark_function fun;
+
+    private:
+        template <typename Clock>
+        static execution_plan<FloatDuration<Clock>> make_plan(configuration const& cfg, parameters params, detail::benchmark_function bench, int iterations, FloatDuration<Clock> iteration_time) {
+            if(cfg.cache == cache_mode::cold_iteration) iterations = 1;
+            return { iterations, iteration_time * iterations * cfg.samples, std::move(params), std::move(bench), chrono::duration_cast<FloatDuration<Clock>>(cfg.max_warmup), detail::steady_state_window };
+        }
     };
 
     using benchmark_registry = std::vector<benchmark>;
@@ -0,0 +1,242 @@
+// Nonius - C++ benchmarking tool
+//
+// Written in 2014- by the nonius contributors <nonius@rmf.io>
+//
+// To the extent possible under law, the author(s) have dedicated all copyright and related
+// and neighboring rights to this software to the public domain worldwide. This software is
+// distributed without any warranty.
+//
+// You should have received a copy of the CC0 Public Domain Dedication along with this software.
+// If not, see <http://creativecommons.org/publicdomain/zero/1.0/>
+
+// Reading binary result files
+
+#ifndef NONIUS_BINARY_RESULTS_HPP
+#define NONIUS_BINARY_RESULTS_HPP
+
+#include <nonius/param.h++>
+#include <nonius/detail/binary_format.h++>
+#include <nonius/detail/noexcept.h++>
+#include <nonius/detail/plan_cache.h++>
+
+#if defined(__unix__) || defined(__APPLE__)
+#   include <fcntl.h>
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <unistd.h>
+#   define NONIUS_HAS_MMAP
+#endif
+
+#ifdef NONIUS_USE_ZLIB
+#   include <zlib.h>
+#endif
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace nonius {
+    struct binary_results_error : virtual std::exception {
+        explicit binary_results_error(std::string message) : message(std::move(message)) {}
+
+        char const* what() const NONIUS_NOEXCEPT override {
+            return message.c_str();
+        }
+
+        std::string message;
+    };
+
+    namespace detail {
+        // Columns that were deflated when written, inflated on first use and kept as long as the
+        // results they came from.
+        struct inflated_columns {
+            double const* get(char const* base, binary_record const& r) {
+                auto&& column = columns[&r];
+                if(column.size() != r.sample_count) column = inflate(base + r.samples_offset, r);
+                return column.data();
+            }
+
+#ifdef NONIUS_USE_ZLIB
+            static std::vector<double> inflate(char const* data, binary_record const& r) {
+                std::vector<double> column(static_cast<std::size_t>(r.sample_count));
+                uLongf size = static_cast<uLongf>(column.size() * sizeof(double));
+                if(uncompress(reinterpret_cast<Bytef*>(column.data()), &size, reinterpret_cast<Bytef const*>(data), static_cast<uLong>(r.samples_size)) != Z_OK
+                   || size != column.size() * sizeof(double)) throw binary_results_error("a column of compressed samples is corrupt");
+                return column;
+            }
+#else
+            static std::vector<double> inflate(char const*, binary_record const&) {
+                throw binary_results_error("the samples are compressed; #define NONIUS_USE_ZLIB and link with zlib to read them");
+            }
+#endif
+
+            std::map<binary_record const*, std::vector<double>> columns;
+        };
+    } // namespace detail
+
+    // A view of one benchmark run with one set of parameters; it points into the file and is
+    // valid as long as the binary_results it came from.
+    struct binary_result {
+        std::string name() const { return { base + record->name_offset, record->name_size }; }
+        std::string params() const { return { base + record->params_offset, record->params_size }; } // as "k=v;k=v"
+        bool failed() const { return (record->flags & detail::binary_failed) != 0; }
+        std::string failure() const { return { base + record->failure_offset, record->failure_size }; }
+
+        // seconds per iteration; compressed columns are inflated on first use
+        bool compressed() const { return (record->flags & detail::binary_compressed) != 0; }
+        double const* samples_begin() const {
+            if(compressed()) return inflated->get(base, *record);
+            return reinterpret_cast<double const*>(base + record->samples_offset);
+        }
+        double const* samples_end() const { return samples_begin() + record->sample_count; }
+        std::size_t sample_count() const { return static_cast<std::size_t>(record->sample_count); }
+        std::uint64_t iterations() const { return record->iterations; }
+
+        // only meaningful when analysed
+        bool analysed() const { return (record->flags & detail::binary_analysed) != 0; }
+        double mean() const { return record->mean; }
+        double mean_lower_bound() const { return record->mean_lower_bound; }
+        double mean_upper_bound() const { return record->mean_upper_bound; }
+        double standard_deviation() const { return record->standard_deviation; }
+
+        explicit operator bool() const { return record != nullptr; }
+
+        char const* base;
+        detail::binary_record const* record;
+        detail::inflated_columns* inflated;
+    };
+
+    // A file written by the binary reporter, memory-mapped where possible and read whole
+    // otherwise. Opening only checks the header and the index; samples are paged in when used.
+    // Reading compressed samples is not thread-safe.
+    struct binary_results {
+        explicit binary_results(std::string const& file) {
+#ifdef NONIUS_HAS_MMAP
+            int fd = ::open(file.c_str(), O_RDONLY);
+            if(fd < 0) throw binary_results_error("could not open " + file);
+            struct stat st;
+            if(::fstat(fd, &st) == 0 && st.st_size > 0) {
+                bytes = static_cast<std::size_t>(st.st_size);
+                auto mapped = ::mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+                if(mapped != MAP_FAILED) data = static_cast<char const*>(mapped);
+            }
+            ::close(fd);
+            if(!data) throw binary_results_error("could not map " + file);
+#else
+            std::ifstream in(file, std::ios::binary | std::ios::ate);
+            if(!in) throw binary_results_error("could not open " + file);
+            bytes = static_cast<std::size_t>(in.tellg());
+            buffer.resize((bytes + sizeof(double) - 1) / sizeof(double)); // aligned for the samples
+            in.seekg(0);
+            in.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(bytes));
+            data = reinterpret_cast<char const*>(buffer.data());
+#endif
+            try {
+                validate(file);
+            } catch(...) {
+                release();
+                throw;
+            }
+        }
+        binary_results(binary_results&& that) NONIUS_NOEXCEPT
+        : data(that.data), bytes(that.bytes), records(that.records), count(that.count), inflated(std::move(that.inflated))
+#ifndef NONIUS_HAS_MMAP
+        , buffer(std::move(that.buffer))
+#endif
+        {
+            that.data = nullptr;
+        }
+        binary_results(binary_results const&) = delete;
+        binary_results& operator=(binary_results const&) = delete;
+        ~binary_results() { release(); }
+
+        std::size_t size() const { return count; }
+        binary_result operator[](std::size_t i) const { return { data, records + i, inflated.get() }; }
+
+        // Records are sorted by name and then parameters.
+        std::vector<binary_result> find(std::string const& name) const {
+            std::vector<binary_result> found;
+            auto first = std::lower_bound(records, records + count, name, [this](detail::binary_record const& r, std::string const& n) {
+                return compare(r.name_offset, r.name_size, n) < 0;
+            });
+            for(auto it = first; it != records + count && compare(it->name_offset, it->name_size, name) == 0; ++it) {
+                found.push_back({ data, it, inflated.get() });
+            }
+            return found;
+        }
+        // False if there is no such record.
+        binary_result find(std::string const& name, parameters const& params) const {
+            auto key = detail::params_key(params);
+            auto less = [this](detail::binary_record const& r, std::pair<std::string const*, std::string const*> k) {
+                auto c = compare(r.name_offset, r.name_size, *k.first);
+                return c < 0 || (c == 0 && compare(r.params_offset, r.params_size, *k.second) < 0);
+            };
+            auto k = std::make_pair(&name, &key);
+            auto it = std::lower_bound(records, records + count, k, less);
+            if(it == records + count || compare(it->name_offset, it->name_size, name) != 0 || compare(it->params_offset, it->params_size, key) != 0) return { data, nullptr, nullptr };
+            return { data, it, inflated.get() };
+        }
+
+    private:
+        void validate(std::string const& file) {
+            auto corrupt = [&file] { return binary_results_error(file + " is not a complete binary result file"); };
+            detail::binary_header header;
+            detail::binary_footer footer;
+            if(bytes < sizeof(header) + sizeof(footer)) throw corrupt();
+            std::memcpy(&header, data, sizeof(header));
+            std::memcpy(&footer, data + bytes - sizeof(footer), sizeof(footer));
+            if(std::memcmp(header.magic, detail::binary_magic, sizeof(header.magic)) != 0
+               || std::memcmp(footer.magic, detail::binary_index_magic, sizeof(footer.magic)) != 0) throw corrupt();
+            if(header.byte_order != detail::binary_byte_order) throw binary_results_error(file + " was written with another byte order");
+            if(header.version != detail::binary_version) throw binary_results_error(file + " has an unknown version");
+
+            auto index_end = bytes - sizeof(footer);
+            if(footer.index_offset % 8 != 0 || footer.index_offset > index_end
+               || footer.record_count != (index_end - footer.index_offset) / sizeof(detail::binary_record)) throw corrupt();
+            records = reinterpret_cast<detail::binary_record const*>(data + footer.index_offset);
+            count = static_cast<std::size_t>(footer.record_count);
+            auto within = [this](std::uint64_t offset, std::uint64_t n) { return offset <= bytes && n <= bytes - offset; };
+            for(std::size_t i = 0; i < count; ++i) {
+                auto&& r = records[i];
+                if(!within(r.name_offset, r.name_size) || !within(r.params_offset, r.params_size) || !within(r.failure_offset, r.failure_size)
+                   || r.samples_offset % 8 != 0 || !within(r.samples_offset, r.samples_size)) throw corrupt();
+                auto compressed = (r.flags & detail::binary_compressed) != 0;
+                if(r.sample_count > (compressed ? std::numeric_limits<std::uint32_t>::max() : r.samples_size) / sizeof(double)
+                   || (!compressed && r.samples_size != r.sample_count * sizeof(double))) throw corrupt();
+            }
+        }
+
+        int compare(std::uint64_t offset, std::uint32_t n, std::string const& s) const {
+            auto c = std::memcmp(data + offset, s.data(), std::min<std::size_t>(n, s.size()));
+            if(c != 0) return c;
+            return n < s.size() ? -1 : n > s.size() ? 1 : 0;
+        }
+
+        void release() {
+#ifdef NONIUS_HAS_MMAP
+            if(data) ::munmap(const_cast<char*>(data), bytes);
+#endif
+            data = nullptr;
+        }
+
+        char const* data = nullptr;
+        std::size_t bytes = 0;
+        detail::binary_record const* records = nullptr;
+        std::size_t count = 0;
+        std::unique_ptr<detail::inflated_columns> inflated { new detail::inflated_columns };
+#ifndef NONIUS_HAS_MMAP
+        std::vector<double> buffer;
+#endif
+    };
+} // namespace nonius
+
+#endif // NONIUS_BINARY_RESULTS_HPP
@@ -15,10 +15,18 @@
 #define NONIUS_CHRONOMETER_HPP
 
 #include <nonius/clock.h++>
+#include <nonius/detail/allocation_counters.h++>
+#include <nonius/detail/async.h++>
+#include <nonius/detail/cache_flush.h++>
 #include <nonius/detail/complete_invoke.h++>
+#include <nonius/detail/frequency.h++>
 #include <nonius/detail/meta.h++>
+#include <nonius/detail/setup_batch.h++>
 #include <nonius/param.h++>
 
+#include <algorithm>
+#include <exception>
+#include <thread>
 #include <type_traits>
 #include <utility>
 
@@ -31,20 +39,76 @@ namespace nonius {
         };
         template <typename Clock>
         struct chronometer_model final : public chronometer_concept {
-            void start() override { started = Clock::now(); }
-            void finish() override { finished = Clock::now(); }
+            void start() override {
+                if(flush_caches) global_cache_flusher()();
+                arm_allocation_counters();
+                if(frequency) frequency->start();
+                started = Clock::now();
+            }
+            void finish() override {
+                finished = Clock::now();
+                if(frequency) frequency->finish();
+                disarm_allocation_counters();
+                total += finished - started;
+                ++regions;
+            }
 
-            Duration<Clock> elapsed() const { return finished - started; }
+            // Sum of all the timed regions, as a measurement may be split in several.
+            Duration<Clock> elapsed() const { return total; }
 
             TimePoint<Clock> started;
             TimePoint<Clock> finished;
+            Duration<Clock> total = Duration<Clock>::zero();
+            int regions = 0; // each one pays for a pair of clock calls
+            bool flush_caches = false;
+            frequency_meter<Clock>* frequency = nullptr;
+            bool direct = false; // set when the runs were timed without the virtual interface
         };
+
+        template <typename Clock, typename Fun>
+        struct static_benchmark_fn;
     } // namespace detail
 
     struct chronometer {
     public:
         template <typename Fun>
-        void measure(Fun&& fun) { measure(std::forward<Fun>(fun), detail::is_callable<Fun(int)>()); }
+        void measure(Fun&& fun) { measure_runs(std::forward<Fun>(fun), detail::is_callable<Fun(int)>()); }
+
+        // Calls setup() (or setup(i)) for every run ahead of time and times only fun on the results.
+        // With batch_size, at most that many inputs are alive at once; otherwise only their own
+        // size is bounded, not any memory they own.
+        template <typename Setup, typename Fun>
+        void measure(Setup&& setup, Fun&& fun, int batch_size = 0) {
+            measure_with_setup(std::forward<Setup>(setup), std::forward<Fun>(fun), batch_size, detail::is_callable<Setup(int)>());
+        }
+
+        // Starts every run with fun(i, done), or co_awaits fun(i) when coroutines are available, and
+        // times until all of them have completed; poll() is called while waiting, so that event loops
+        // running on this thread can make progress. With max_in_flight, at most that many runs are
+        // pending at any time.
+        template <typename Fun>
+        void measure_async(Fun&& fun, int max_in_flight = 0) {
+            measure_async(std::forward<Fun>(fun), [] { std::this_thread::yield(); }, max_in_flight);
+        }
+        template <typename Fun, typename Poll, typename = typename std::enable_if<detail::is_callable<Poll&()>::value>::type>
+        void measure_async(Fun&& fun, Poll&& poll, int max_in_flight = 0) {
+            detail::completion_counter counter;
+            int started = 0;
+            impl->start();
+            try {
+                for(; started < k; ++started) {
+                    while(max_in_flight > 0 && started - counter.count() >= max_in_flight) poll();
+                    start_async(fun, started, completion{&counter}, detail::is_callable<Fun&(int, completion)>());
+                }
+            } catch(...) {
+                while(counter.count() < started) poll();
+                impl->finish();
+                throw;
+            }
+            while(counter.count() < k) poll();
+            impl->finish();
+            counter.rethrow();
+        }
 
         int runs() const { return k; }
 
@@ -60,17 +124,53 @@ namespace nonius {
         }
 
     private:
+        template <typename Clock, typename Fun>
+        friend struct detail::static_benchmark_fn;
+
         template <typename Fun>
-        void measure(Fun&& fun, std::false_type) {
-            measure([&fun](int) { fun(); });
+        void measure_runs(Fun&& fun, std::false_type) {
+            measure_runs([&fun](int) { fun(); }, std::true_type());
         }
         template <typename Fun>
-        void measure(Fun&& fun, std::true_type) {
+        void measure_runs(Fun&& fun, std::true_type) {
             impl->start();
             for(int i = 0; i < k; ++i) fun(i);
             impl->finish();
         }
 
+        template <typename Fun>
+        static void start_async(Fun& fun, int i, completion done, std::true_type) {
+            fun(i, done);
+        }
+        template <typename Fun>
+        static void start_async(Fun& fun, int i, completion done, std::false_type) {
+#ifdef NONIUS_HAS_COROUTINES
+            detail::await_completion(fun(i), done);
+#else
+            static_assert(detail::is_callable<Fun&(int, completion)>::value, "asynchronous benchmarks take the run index and a completion");
+            (void)fun; (void)i; (void)done;
+#endif
+        }
+
+        template <typename Setup, typename Fun>
+        void measure_with_setup(Setup&& setup, Fun&& fun, int batch_size, std::false_type) {
+            measure_with_setup([&setup](int) { return setup(); }, fun, batch_size, std::true_type());
+        }
+        template <typename Setup, typename Fun>
+        void measure_with_setup(Setup&& setup, Fun&& fun, int batch_size, std::true_type) {
+            using input = typename std::decay<detail::ResultOf<Setup&(int)>>::type;
+            auto capacity = detail::setup_batch_capacity(sizeof(input), k, batch_size);
+            detail::setup_batch<input> batch(capacity);
+            for(int done = 0; done < k; done += capacity) {
+                auto chunk = std::min(capacity, k - done);
+                batch.clear();
+                for(int i = 0; i < chunk; ++i) batch.emplace_back(setup(done + i));
+                impl->start();
+                for(int i = 0; i < chunk; ++i) fun(batch[i]);
+                impl->finish();
+            }
+        }
+
         detail::chronometer_concept* impl;
         int k;
         const parameters* params;
@@ -14,6 +14,7 @@
 #ifndef NONIUS_CONFIGURATION_HPP
 #define NONIUS_CONFIGURATION_HPP
 
+#include <nonius/clock.h++>
 #include <nonius/param.h++>
 
 #if !defined(NONIUS_USE_BOOST_OPTIONAL) && defined(__has_include)
@@ -35,9 +36,16 @@
 #endif
 
 #include <string>
+#include <vector>
 #include <cstddef>
 
 namespace nonius {
+    enum class cache_mode {
+        warm,           // caches are left as they are between samples
+        cold_sample,    // data caches are evicted before each sample
+        cold_iteration, // each sample is a single iteration, run after evicting data caches
+    };
+
     struct run_configuration {
         std::string name;
         std::string op;
@@ -46,6 +54,11 @@ namespace nonius {
         std::size_t count;
     };
 
+    struct shard_configuration {
+        int index = 1; // counting from one
+        int count = 1;
+    };
+
     struct param_configuration {
         parameters map;
         NONIUS_OPTIONAL_NS::optional<run_configuration> run;
@@ -53,6 +66,15 @@ namespace nonius {
 
     struct configuration {
         int samples = 100;
+        int first_calls = 0;
+        double target_rel_ci = 0.; // adaptive sampling is disabled when zero
+        double max_time = 10.; // seconds spent sampling each benchmark in adaptive mode
+        fp_seconds max_warmup = fp_seconds(1);
+        fp_seconds time_budget = fp_seconds::zero(); // no budget when zero
+        std::string plan_cache;
+        bool pin_plans = false;
+        std::string env_cache;
+        fp_seconds env_cache_expiry = fp_seconds(3600);
         double confidence_interval = 0.95;
         int resamples = 100000;
         std::string title = "benchmarks";
@@ -63,6 +85,14 @@ namespace nonius {
         bool list_params = false;
         bool list_reporters = false;
         bool no_analysis = false;
+        bool isolate = false;
+        bool interleave = false;
+        int jobs = 1;
+        bool jobs_per_l3 = false;
+        shard_configuration shard;
+        std::vector<std::string> merge_files;
+        cache_mode cache = cache_mode::warm;
+        bool frequency = false;
         bool verbose = false;
         bool summary = false;
         bool help = false;
@@ -0,0 +1,106 @@
+// Nonius - C++ benchmarking tool
+//
+// Written in 2014- by the nonius contributors <nonius@rmf.io>
+//
+// To the extent possible under law, the author(s) have dedicated all copyright and related
+// and neighboring rights to this software to the public domain worldwide. This software is
+// distributed without any warranty.
+//
+// You should have received a copy of the CC0 Public Domain Dedication along with this software.
+// If not, see <http://creativecommons.org/publicdomain/zero/1.0/>
+
+// Allocation counters
+
+#ifndef NONIUS_DETAIL_ALLOCATION_COUNTERS_HPP
+#define NONIUS_DETAIL_ALLOCATION_COUNTERS_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+namespace nonius {
+    struct allocation_stats {
+        std::uint64_t calls = 0;
+        std::uint64_t bytes = 0;
+        std::uint64_t peak_bytes = 0; // largest growth in live bytes within a single timed region
+        std::uint64_t iterations = 0;
+
+        double calls_per_iteration() const {
+            return iterations > 0 ? static_cast<double>(calls) / iterations : 0.;
+        }
+        double bytes_per_iteration() const {
+            return iterations > 0 ? static_cast<double>(bytes) / iterations : 0.;
+        }
+    };
+
+    namespace detail {
+        // All counters are constant-initialized, so they are usable from operator new during
+        // static initialization.
+        struct allocation_counters {
+            std::atomic<bool> enabled { false }; // set when the replacement operators are linked in
+            std::atomic<bool> armed { false };   // set while inside a timed region
+            std::atomic<std::uint64_t> calls { 0 };
+            std::atomic<std::uint64_t> bytes { 0 };
+            std::atomic<std::int64_t> live { 0 };
+            std::atomic<std::int64_t> peak { 0 };
+            std::atomic<std::int64_t> max_peak { 0 };
+        };
+
+        inline allocation_counters& global_allocation_counters() {
+            static allocation_counters counters;
+            return counters;
+        }
+
+        inline bool allocation_tracking_enabled() {
+            return global_allocation_counters().enabled.load(std::memory_order_relaxed);
+        }
+
+        inline void record_allocation(std::size_t size) {
+            auto&& c = global_allocation_counters();
+            if(!c.armed.load(std::memory_order_relaxed)) return;
+            c.calls.fetch_add(1, std::memory_order_relaxed);
+            c.bytes.fetch_add(size, std::memory_order_relaxed);
+            auto live = c.live.fetch_add(static_cast<std::int64_t>(size), std::memory_order_relaxed) + static_cast<std::int64_t>(size);
+            auto peak = c.peak.load(std::memory_order_relaxed);
+            while(live > peak && !c.peak.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+        }
+        inline void record_deallocation(std::size_t size) {
+            auto&& c = global_allocation_counters();
+            if(!c.armed.load(std::memory_order_relaxed)) return;
+            c.live.fetch_sub(static_cast<std::int64_t>(size), std::memory_order_relaxed);
+        }
+
+        inline void arm_allocation_counters() {
+            auto&& c = global_allocation_counters();
+            if(!c.enabled.load(std::memory_order_relaxed)) return;
+            c.live.store(0, std::memory_order_relaxed);
+            c.peak.store(0, std::memory_order_relaxed);
+            c.armed.store(true, std::memory_order_relaxed);
+        }
+        inline void disarm_allocation_counters() {
+            auto&& c = global_allocation_counters();
+            if(!c.enabled.load(std::memory_order_relaxed)) return;
+            c.armed.store(false, std::memory_order_relaxed);
+            auto peak = c.peak.load(std::memory_order_relaxed);
+            if(peak > c.max_peak.load(std::memory_order_relaxed)) c.max_peak.store(peak, std::memory_order_relaxed);
+        }
+
+        inline void reset_allocation_counters() {
+            auto&& c = global_allocation_counters();
+            c.calls.store(0, std::memory_order_relaxed);
+            c.bytes.store(0, std::memory_order_relaxed);
+            c.max_peak.store(0, std::memory_order_relaxed);
+        }
+        inline allocation_stats allocation_snapshot(std::uint64_t iterations) {
+            auto&& c = global_allocation_counters();
+            allocation_stats s;
+            s.calls = c.calls.load(std::memory_order_relaxed);
+            s.bytes = c.bytes.load(std::memory_order_relaxed);
+            s.peak_bytes = static_cast<std::uint64_t>(c.max_peak.load(std::memory_order_relaxed));
+            s.iterations = iterations;
+            return s;
+        }
+    } // namespace detail
+} // namespace nonius
+
+#endif // NONIUS_DETAIL_ALLOCATION_COUNTERS_HPP
@@ -0,0 +1,86 @@
+// Nonius - C++ benchmarking tool
+//
+// Written in 2014- by the nonius contributors <nonius@rmf.io>
+//
+// To the extent possible under law, the author(s) have dedicated all copyright and related
+// and neighboring rights to this software to the public domain worldwide. This software is
+// distributed without any warranty.
+//
+// You should have received a copy of the CC0 Public Domain Dedication along with this software.
+// If not, see <http://creativecommons.org/publicdomain/zero/1.0/>
+
+// Completion tracking for asynchronous benchmarks
+
+#ifndef NONIUS_DETAIL_ASYNC_HPP
+#define NONIUS_DETAIL_ASYNC_HPP
+
+#if defined(__cpp_impl_coroutine)
+#   include <coroutine>
+#   define NONIUS_HAS_COROUTINES
+#endif
+
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <utility>
+
+namespace nonius {
+    namespace detail {
+        // Counts the operations that completed; completions may come from any thread.
+        struct completion_counter {
+            int count() const { return completed.load(std::memory_order_acquire); }
+
+            void complete() { completed.fetch_add(1, std::memory_order_release); }
+            void fail(std::exception_ptr e) {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if(!error) error = e;
+                }
+                complete();
+            }
+
+            void rethrow() {
+                if(error) std::rethrow_exception(error);
+            }
+
+        private:
+            std::atomic<int> completed { 0 };
+            std::mutex mutex;
+            std::exception_ptr error;
+        };
+    } // namespace detail
+
+    // Handed to each asynchronous operation, to be called exactly once when it completes.
+    struct completion {
+        void operator()() const { counter->complete(); }
+        void fail(std::exception_ptr e) const { counter->fail(std::move(e)); }
+
+        detail::completion_counter* counter;
+    };
+
+#ifdef NONIUS_HAS_COROUTINES
+    namespace detail {
+        struct detached_task {
+            struct promise_type {
+                detached_task get_return_object() noexcept { return {}; }
+                std::suspend_never initial_suspend() noexcept { return {}; }
+                std::suspend_never final_suspend() noexcept { return {}; }
+                void return_void() noexcept {}
+                void unhandled_exception() noexcept { done.fail(std::current_exception()); }
+
+                completion done;
+                template <typename Awaitable>
+                promise_type(Awaitable&, completion done) : done(done) {}
+            };
+        };
+
+        template <typename Awaitable>
+        detached_task await_completion(Awaitable awaitable, completion done) {
+            co_await std::move(awaitable);
+            done();
+        }
+    } // namespace detail
+#endif // NONIUS_HAS_COROUTINES
+} // namespace nonius
+
+#endif // NONIUS_DETAIL_ASYNC_HPP
@@ -0,0 +1,46 @@
+// Nonius - C++ benchmarking tool
+//
+// Written in 2014- by the nonius contributors <nonius@rmf.io>
+//
+// To the extent possible under law, the author(s) have dedicated all copyright and related
+// and neighboring rights to this software to the public domain worldwide. This software is
+// distributed without any warranty.
+//
+// You should have received a copy of the CC0 Public Domain Dedication along with this software.
+// If not, see <http://creativecommons.org/publicdomain/zero/1.0/>
+
+// Base64 encoding
+
+#ifndef NONIUS_DETAIL_BASE64_HPP
+#define NONIUS_DETAIL_BASE64_HPP
+
+#include <cstddef>
+#include <string>
+
+namespace nonius {
+    namespace detail {
+        inline std::string base64_encode(unsigned char const* data, std::size_t size) {
+            static char const digits[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+            std::string encoded;
+            encoded.reserve((size + 2) / 3 * 4);
+            std::size_t i = 0;
+            for(; i + 2 < size; i += 3) {
+                unsigned long bits = static_cast<unsigned long>(data[i]) << 16 | static_cast<unsigned long>(data[i+1]) << 8 | data[i+2];
+                encoded += digits[bits >> 18 & 63];
+                encoded += digits[bits >> 12 & 63];
+                encoded += digits[bits >> 6 & 63];
+                encoded += digits[bits & 63];
+            }
+            if(i < size) {
+                unsigned long bits = static_cast<unsigned long>(data[i]) << 16 | (i + 1 < size ? static_cast<unsigned long>(data[i+1]) << 8 : 0);
+                encoded += digits[bits >> 18 & 63];
+                encoded += digits[bits >> 12 & 63];
+                encoded += i + 1 < size ? digits[bits >> 6 & 63] : '=';
+                encoded += '=';
+            }
+            return encoded;
+        }
+    } // namespace detail
+} // namespace nonius
+
+#endif // NONIUS_DETAIL_BASE64_HPP
@@ -0,0 +1,76 @@
+// Nonius - C++ benchmarking tool
+//
+// Written in 2014- by the nonius contributors <nonius@rmf.io>
+//
+// To the extent possible under law, the author(s) have dedicated all copyright and related
+// and neighboring rights to this software to the public domain worldwide. This software is
+// distributed without any warranty.
+//
+// You should have received a copy of the CC0 Public Domain Dedication along with this software.
+// If not, see <http://creativecommons.org/publicdomain/zero/1.0/>
+
+// Layout of binary result files
+
+#ifndef NONIUS_DETAIL_BINARY_FORMAT_HPP
+#define NONIUS_DETAIL_BINARY_FORMAT_HPP
+
+#include <cstdint>
+
+namespace nonius {
+    namespace detail {
+        // A file is a header, then one column of samples per benchmark in the order they ran,
+        // then the strings, then the index, and last a footer pointing at the index. Everything
+        // is in the byte order of the machine that wrote it, and every column, the index and the
+        // footer start at multiples of eight bytes, so a mapped file can be used in place. When
+        // written with NONIUS_USE_ZLIB, columns that shrink are stored deflated (zlib format) and
+        // flagged as such; those have to be inflated into memory to be read.
+        const char binary_magic[8] = { 'n', 'o', 'n', 'i', 'u', 's', 'b', '\0' };
+        const char binary_index_magic[8] = { 'n', 'o', 'n', 'i', 'u', 's', 'i', '\0' };
+        const std::uint32_t binary_version = 2;
+        const std::uint32_t binary_byte_order = 0x01020304;
+
+        struct binary_header {
+            char magic[8];
+            std::uint32_t version;
+            std::uint32_t byte_order;
+        };
+
+        enum binary_flags : std::uint32_t {
+            binary_analysed = 1,
+            binary_failed = 2,
+            binary_compressed = 4,
+        };
+
+        // One per benchmark and set of parameters, sorted by name and then parameters. Offsets
+        // are from the start of the file; parameters are as written by params_key.
+        struct binary_record {
+            std::uint64_t name_offset;
+            std::uint64_t params_offset;
+            std::uint64_t failure_offset;
+            std::uint32_t name_size;
+            std::uint32_t params_size;
+            std::uint32_t failure_size;
+            std::uint32_t flags;
+            std::uint64_t samples_offset; // float64 seconds
+            std::uint64_t sample_count;
+            std::uint64_t samples_size; // bytes in the file
+            std::uint64_t iterations; // per sample
+            double mean; // seconds
+            double mean_lower_bound;
+            double mean_upper_bound;
+            double standard_deviation;
+        };
+
+        struct binary_footer {
+            std::uint64_t index_offset;
+            std::uint64_t record_count;
+            char magic[8];
+        };
+
+        static_assert(sizeof(binary_header) == 16, "binary header must not be padded");
+        static_assert(sizeof(binary_record) == 104, "binary records must not be padded");
+        static_assert(sizeof(binary_footer) == 24, "binary footer must not be padded");
+    } // namespace detail
+} // namespace nonius
+
+#endif // NONIUS_DETAIL_BINARY_FORMAT_HPP
@@ -0,0 +1,92 @@
+// Nonius - C++ benchmarking tool
+//
+// Written in 2014- by the nonius contributors <nonius@rmf.io>
+//
+// To the extent possible under law, the author(s) have dedicated all copyright and related
+// and neighboring rights to this software to the public domain worldwide. This software is
+// distributed without any warranty.
+//
+// You should have received a copy of the CC0 Public Domain Dedication along with this software.
+// If not, see <http://creativecommons.org/publicdomain/zero/1.0/>
+
+// Data cache eviction
+
+#ifndef NONIUS_DETAIL_CACHE_FLUSH_HPP
+#define NONIUS_DETAIL_CACHE_FLUSH_HPP
+
+#include <nonius/detail/compiler.h++>
+#include <nonius/optimizer.h++>
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cctype>
+
+namespace nonius {
+    namespace detail {
+        const std::size_t cache_line_size = 64;
+        const std::size_t default_eviction_size = std::size_t(32) << 20;
+
+        // Parses sizes in the format used by /sys/devices/system/cpu/cpu*/cache/index*/size, like "32K".
+        inline std::size_t parse_cache_size(std::string const& s) {
+            std::size_t size = 0;
+            auto it = s.begin();
+            for(; it != s.end() && std::isdigit(static_cast<unsigned char>(*it)); ++it) {
+                size = size * 10 + static_cast<std::size_t>(*it - '0');
+            }
+            if(it != s.end()) {
+                switch(std::toupper(static_cast<unsigned char>(*it))) {
+                case 'K': size <<= 10; break;
+                case 'M': size <<= 20; break;
+                case 'G': size <<= 30; break;
+                }
+            }
+            return size;
+        }
+
+        // Size of the largest data cache of the first CPU, or zero if unknown.
+        inline std::size_t largest_data_cache_size() {
+            std::size_t largest = 0;
+            for(int i = 0; i < 16; ++i) {
+                auto dir = "/sys/devices/system/cpu/cpu0/cache/index" + std::to_string(i) + "/";
+                std::ifstream type_file(dir + "type");
+                std::ifstream size_file(dir + "size");
+                std::string type, size;
+                if(!(type_file >> type) || !(size_file >> size)) break;
+                if(type == "Instruction") continue;
+                largest = std::max(largest, parse_cache_size(size));
+            }
+            return largest;
+        }
+
+        // Twice the largest cache so that non-inclusive hierarchies get evicted as well; walking
+        // that many pages also evicts most of the TLB.
+        inline std::size_t eviction_buffer_size() {
+            auto largest = largest_data_cache_size();
+            return largest > 0 ? 2 * largest : default_eviction_size;
+        }
+
+        struct cache_flusher {
+            explicit cache_flusher(std::size_t size = eviction_buffer_size()) : buffer(size) {}
+
+            void operator()() {
+                // writing takes the lines in exclusive state, evicting any other copies
+                for(std::size_t i = 0; i < buffer.size(); i += cache_line_size) {
+                    ++buffer[i];
+                }
+                keep_memory(buffer.data());
+            }
+
+            std::vector<char> buffer;
+        };
+
+        inline cache_flusher& global_cache_flusher() {
+            static cache_flusher flusher;
+            return flusher;
+        }
+    } // namespace detail
+} // namespace nonius
+
+#endif // NONIUS_DETAIL_CACHE_FLUSH_HPP
@@ -0,0 +1,149 @@
+// Nonius - C++ benchmarking tool
+//
+// Written in 2014- by the nonius contributors <nonius@rmf.io>
+//
+// To the extent possible under law, the author(s) have dedicated all copyright and related
+// and neighboring rights to this software to the public domain worldwide. This software is
+// distributed without any warranty.
+//
+// You should have received a copy of the CC0 Public Domain Dedication along with this software.
+// If not, see <http://creativecommons.org/publicdomain/zero/1.0/>
+
+// Trend and change point detection over the sample series
+
+#ifndef NONIUS_DETAIL_DRIFT_HPP
+#define NONIUS_DETAIL_DRIFT_HPP
+
+#include <nonius/clock.h++>
+#include <nonius/drift_analysis.h++>
+
+#include <boost/math/distributions/fisher_f.hpp>
+#include <boost/math/distributions/normal.hpp>
+
+#include <algorithm>
+#include <vector>
+#include <limits>
+#include <cmath>
+#include <cstddef>
+
+namespace nonius {
+    namespace detail {
+        const int drift_min_samples = 10;
+        const int drift_min_segment = 5;
+        const double drift_significance = 0.01;
+        const double drift_min_effect = 0.02; // changes smaller than this fraction of the mean are ignored
+
+        inline double mann_kendall_z(std::vector<double> const& y) {
+            auto n = static_cast<double>(y.size());
+            double s = 0.;
+            for(std::size_t i = 0; i < y.size(); ++i) {
+                for(std::size_t j = i + 1; j < y.size(); ++j) {
+                    s += (y[j] > y[i]) - (y[j] < y[i]);
+                }
+            }
+            // ties make for fewer possible orderings
+            std::vector<double> sorted(y);
+            std::sort(sorted.begin(), sorted.end());
+            double ties = 0.;
+            for(std::size_t i = 0; i < sorted.size();) {
+                auto j = i;
+                while(j < sorted.size() && sorted[j] == sorted[i]) ++j;
+                double t = static_cast<double>(j - i);
+                ties += t * (t - 1) * (2 * t + 5);
+                i = j;
+            }
+            auto variance = (n * (n - 1) * (2 * n + 5) - ties) / 18.;
+            if(variance <= 0.) return 0.;
+            if(s > 0) return (s - 1) / std::sqrt(variance);
+            if(s < 0) return (s + 1) / std::sqrt(variance);
+            return 0.;
+        }
+
+        // Least squares lines over ranges of the series, from running sums.
+        struct line_fits {
+            line_fits(std::vector<double> const& x, std::vector<double> const& y)
+            : sx(1, 0.), sy(1, 0.), sxx(1, 0.), sxy(1, 0.), syy(1, 0.) {
+                for(std::size_t i = 0; i < x.size(); ++i) {
+                    sx.push_back(sx.back() + x[i]);
+                    sy.push_back(sy.back() + y[i]);
+                    sxx.push_back(sxx.back() + x[i] * x[i]);
+                    sxy.push_back(sxy.back() + x[i] * y[i]);
+                    syy.push_back(syy.back() + y[i] * y[i]);
+                }
+            }
+
+            double slope(std::size_t first, std::size_t last) const {
+                double n = static_cast<double>(last - first);
+                auto vx = (sxx[last] - sxx[first]) - (sx[last] - sx[first]) * (sx[last] - sx[first]) / n;
+                auto cxy = (sxy[last] - sxy[first]) - (sx[last] - sx[first]) * (sy[last] - sy[first]) / n;
+                return vx > 0. ? cxy / vx : 0.;
+            }
+            double mean(std::size_t first, std::size_t last) const {
+                return (sy[last] - sy[first]) / (last - first);
+            }
+            double sse(std::size_t first, std::size_t last) const {
+                double n = static_cast<double>(last - first);
+                auto vx = (sxx[last] - sxx[first]) - (sx[last] - sx[first]) * (sx[last] - sx[first]) / n;
+                auto vy = (syy[last] - syy[first]) - (sy[last] - sy[first]) * (sy[last] - sy[first]) / n;
+                auto cxy = (sxy[last] - sxy[first]) - (sx[last] - sx[first]) * (sy[last] - sy[first]) / n;
+                auto explained = vx > 0. ? cxy * cxy / vx : 0.;
+                return std::max(vy - explained, 0.);
+            }
+
+            std::vector<double> sx, sy, sxx, sxy, syy;
+        };
+
+        // Looks for a monotonic trend with the Mann-Kendall test, and for a change in level with a
+        // two-segment regression over time, accepted when it fits significantly better than a
+        // single line.
+        template <typename Duration>
+        drift_analysis analyse_drift(std::vector<fp_seconds> const& starts, std::vector<Duration> const& samples) {
+            drift_analysis drift;
+            auto n = std::min(starts.size(), samples.size());
+            if(n < static_cast<std::size_t>(drift_min_samples)) return drift;
+
+            std::vector<double> x, y;
+            for(std::size_t i = 0; i < n; ++i) {
+                x.push_back(starts[i].count());
+                y.push_back(samples[i].count());
+            }
+            line_fits fits(x, y);
+            auto mean = fits.mean(0, n);
+            if(mean <= 0.) return drift;
+
+            namespace bm = boost::math;
+            drift.trend_z = mann_kendall_z(y);
+            drift.trend_p = 2 * bm::cdf(bm::complement(bm::normal{}, std::abs(drift.trend_z)));
+            drift.trend = fits.slope(0, n) * (x[n - 1] - x[0]) / mean;
+
+            auto single = fits.sse(0, n);
+            auto best = single;
+            std::size_t split = 0;
+            for(auto b = static_cast<std::size_t>(drift_min_segment); b + drift_min_segment <= n; ++b) {
+                auto sse = fits.sse(0, b) + fits.sse(b, n);
+                if(sse < best) {
+                    best = sse;
+                    split = b;
+                }
+            }
+            if(split > 0 && n > 4) {
+                // two lines and a breakpoint against one line
+                auto df = static_cast<double>(n - 5);
+                auto f = best > 0. ? ((single - best) / 3.) / (best / df) : std::numeric_limits<double>::infinity();
+                auto critical = bm::quantile(bm::complement(bm::fisher_f(3., df), drift_significance));
+                auto before = fits.mean(0, split);
+                if(f > critical && before > 0.) {
+                    drift.change_point = static_cast<int>(split);
+                    drift.shift = (fits.mean(split, n) - before) / before;
+                }
+            }
+
+            auto trending = drift.trend_p < drift_significance && std::abs(drift.trend) > drift_min_effect;
+            auto shifted = drift.change_point >= 0 && std::abs(drift.shift) > drift_min_effect;
+            drift.stationary = !trending && !shifted;
+            return drift;
+        }
+    } // namespace detail
+} // namespace nonius
+
+#endif // NONIUS_DETAIL_DRIFT_HPP
@@ -0,0 +1,132 @@
+// Nonius - C++ benchmarking tool
+//
+// Written in 2014- by the nonius contributors <nonius@rmf.io>
+//
+// To the extent possible under law, the author(s) have dedicated all copyright and related
+// and neighboring rights to this software to the public domain worldwide. This software is
+// distributed without any warranty.
+//
+// You should have received a copy of the CC0 Public Domain Dedication along with this software.
+// If not, see <http://creativecommons.org/publicdomain/zero/1.0/>
+
+// Persistent cache of environment estimates
+
+#ifndef NONIUS_DETAIL_ENVIRONMENT_CACHE_HPP
+#define NONIUS_DETAIL_ENVIRONMENT_CACHE_HPP
+
+#include <nonius/clock.h++>
+#include <nonius/environment.h++>
+#include <nonius/outlier_classification.h++>
+#include <nonius/detail/plan_cache.h++>
+
+#if defined(__unix__) || defined(__APPLE__)
+#   include <unistd.h>
+#   include <sys/utsname.h>
+#   define NONIUS_HAS_UNAME
+#endif
+
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+namespace nonius {
+    namespace detail {
+        // Host name, CPU model and kernel release, as far as they can be found.
+        inline std::string host_identity() {
+            std::string host, cpu, kernel;
+#ifdef NONIUS_HAS_UNAME
+            char name[256] = {};
+            if(::gethostname(name, sizeof(name) - 1) == 0) host = name;
+            struct utsname u;
+            if(::uname(&u) == 0) kernel = std::string(u.sysname) + " " + u.release;
+#endif
+            std::ifstream cpuinfo("/proc/cpuinfo");
+            std::string line;
+            while(std::getline(cpuinfo, line)) {
+                if(line.compare(0, 10, "model name") == 0) {
+                    auto colon = line.find(':');
+                    if(colon != std::string::npos) cpu = line.substr(line.find_first_not_of(' ', colon + 1));
+                    break;
+                }
+            }
+            return host + "|" + cpu + "|" + kernel;
+        }
+
+        template <typename Clock>
+        std::string environment_cache_key() {
+            using period = typename Clock::period;
+            return host_identity() + "|" + typeid(Clock).name() + "|" + std::to_string(period::num) + "/" + std::to_string(period::den);
+        }
+
+        inline void put_estimate(std::ostream& os, environment_estimate<fp_seconds> const& e) {
+            auto&& o = e.outliers;
+            os << '\t' << e.mean.count() << '\t' << o.samples_seen << '\t' << o.low_severe << '\t' << o.low_mild << '\t' << o.high_mild << '\t' << o.high_severe;
+        }
+        inline environment_estimate<fp_seconds> get_estimate(std::vector<std::string> const& fields, std::size_t first) {
+            environment_estimate<fp_seconds> e;
+            e.mean = fp_seconds(std::stod(fields[first]));
+            e.outliers.samples_seen = std::stoi(fields[first + 1]);
+            e.outliers.low_severe = std::stoi(fields[first + 2]);
+            e.outliers.low_mild = std::stoi(fields[first + 3]);
+            e.outliers.high_mild = std::stoi(fields[first + 4]);
+            e.outliers.high_severe = std::stoi(fields[first + 5]);
+            return e;
+        }
+
+        // One line per key: key, time of measurement in seconds since the epoch, and then the clock
+        // resolution, the clock cost and the function cost, each as the mean in seconds followed by
+        // the outlier counts.
+        inline bool find_cached_environment(std::istream& is, std::string const& key, double now, double max_age, environment<fp_seconds>& env) {
+            std::string line;
+            while(std::getline(is, line)) {
+                auto fields = split_fields(line);
+                if(fields.size() != 20 || fields[0] != key) continue;
+                try {
+                    auto stored = std::stod(fields[1]);
+                    if(now - stored > max_age || stored > now) return false;
+                    env.clock_resolution = get_estimate(fields, 2);
+                    env.clock_cost = get_estimate(fields, 8);
+                    env.function_cost = get_estimate(fields, 14);
+                    return true;
+                } catch(std::exception const&) {
+                    return false;
+                }
+            }
+            return false;
+        }
+
+        // Copies the entries for other hosts and clocks and adds the one for the key.
+        template <typename Duration>
+        void update_environment_cache(std::istream& is, std::ostream& os, std::string const& key, double now, environment<Duration> const& env) {
+            std::string line;
+            while(std::getline(is, line)) {
+                auto fields = split_fields(line);
+                if(!fields.empty() && fields[0] != key) os << line << '\n';
+            }
+            auto precision = os.precision(17);
+            os << escape_field(key) << '\t' << now;
+            put_estimate(os, env.clock_resolution);
+            put_estimate(os, env.clock_cost);
+            put_estimate(os, env.function_cost);
+            os << '\n';
+            os.precision(precision);
+        }
+
+        template <typename Duration>
+        void store_environment(std::string const& file, std::string const& key, double now, environment<Duration> const& env) {
+            std::stringstream old;
+            {
+                std::ifstream in(file);
+                old << in.rdbuf();
+            }
+            std::ofstream out(file);
+            update_environment_cache(old, out, key, now, env);
+        }
+    } // namespace detail
+} // namespace nonius
+
+#endif // NONIUS_DETAIL_ENVIRONMENT_CACHE_HPP
@@ -50,6 +50,8 @@ namespace nonius {
         const auto clock_cost_estimation_tick_limit = 100000;
         const auto clock_cost_estimation_time = chrono::milliseconds(10);
         const auto clock_cost_estimation_iterations = 10000;
+        const auto function_cost_estimation_time = chrono::milliseconds(100);
+        const auto function_cost_estimation_samples = 100000;
 
         template <typename Clock>
         int warmup() {
@@ -90,6 +92,33 @@ namespace nonius {
                 classify_outliers(times.begin(), times.end()),
             };
         }
+
+        // Times an empty benchmark through the same path as the real ones, so that the cost of the
+        // dispatch and of starting and stopping the chronometer can be taken out of each sample.
+        template <typename Clock>
+        environment_estimate<FloatDuration<Clock>> estimate_function_cost(FloatDuration<Clock> clock_cost) {
+            benchmark_function empty = [] {};
+            parameters params;
+            auto time_call = [&] {
+                chronometer_model<Clock> model;
+                optimizer_barrier();
+                empty(chronometer(model, 1, params));
+                optimizer_barrier();
+                return model.elapsed();
+            };
+            time_call();
+            std::vector<double> times;
+            times.reserve(function_cost_estimation_samples);
+            auto deadline = Clock::now() + chrono::duration_cast<Duration<Clock>>(function_cost_estimation_time);
+            do {
+                times.push_back((time_call() - clock_cost).count());
+            } while(static_cast<int>(times.size()) < function_cost_estimation_samples && Clock::now() < deadline);
+            auto cost = std::max(mean(times.begin(), times.end()), 0.);
+            return {
+                FloatDuration<Clock>(cost),
+                classify_outliers(times.begin(), times.end()),
+            };
+        }
     } // namespace detail
 } // namespace nonius
 
@@ -0,0 +1,122 @@
+// Nonius - C++ benchmarking tool
+//
+// Written in 2014- by the nonius contributors <nonius@rmf.io>
+//
+// To the extent possible under law, the author(s) have dedicated all copyright and related
+// and neighboring rights to this software to the public domain worldwide. This software is
+// distributed without any warranty.
+//
+// You should have received a copy of the CC0 Public Domain Dedication along with this software.
+// If not, see <http://creativecommons.org/publicdomain/zero/1.0/>
+
+// Fast number formatting for bulk output
+
+#ifndef NONIUS_DETAIL_FORMAT_NUMBER_HPP
+#define NONIUS_DETAIL_FORMAT_NUMBER_HPP
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+namespace nonius {
+    namespace detail {
+        const int format_number_digits = 15; // significant; as many as a double always keeps
+        const int format_number_size = 32; // enough for any output
+
+        inline char* format_integer(std::uint64_t n, char* out) {
+            char digits[20];
+            int k = 0;
+            do {
+                digits[k++] = static_cast<char>('0' + n % 10);
+                n /= 10;
+            } while(n > 0);
+            while(k > 0) *out++ = digits[--k];
+            return out;
+        }
+
+        // Writes x like printf's %.15g, without its locale and parsing overhead, and returns
+        // the end of the output. The last digit can be off by one in values within a hair of
+        // halfway between two outputs, more often where long double is no wider than double.
+        inline char* format_number(double x, char* out) {
+            // scaled in extended precision, where there is any, so that rounding sees the digits
+            // past the fifteenth
+            static const long double powers[] = {
+                1e0L, 1e1L, 1e2L, 1e3L, 1e4L, 1e5L, 1e6L, 1e7L, 1e8L, 1e9L, 1e10L, 1e11L,
+                1e12L, 1e13L, 1e14L, 1e15L, 1e16L, 1e17L, 1e18L, 1e19L, 1e20L, 1e21L, 1e22L,
+            };
+            const int max_power = 22;
+            const std::uint64_t low = 100000000000000; // smallest mantissa with all the digits
+            const std::uint64_t high = low * 10;
+
+            if(x == 0) {
+                *out++ = '0';
+                return out;
+            }
+            auto fallback = [&] { return out + std::snprintf(out, format_number_size, "%.15g", x); };
+            if(!std::isfinite(x)) return fallback();
+            long double magnitude = std::fabs(x);
+            int exponent = static_cast<int>(std::floor(std::log10(std::fabs(x))));
+            auto scaled_by = [&](int scale) { return scale >= 0 ? magnitude * powers[scale] : magnitude / powers[-scale]; };
+            int scale = format_number_digits - 1 - exponent;
+            if(scale > max_power || scale < -max_power) return fallback();
+            auto scaled = scaled_by(scale);
+            if(scaled < low) { // log10 rounded up
+                if(++scale > max_power) return fallback();
+                --exponent;
+                scaled = scaled_by(scale);
+            } else if(scaled >= high) { // log10 rounded down
+                if(--scale < -max_power) return fallback();
+                ++exponent;
+                scaled = scaled_by(scale);
+            }
+            auto mantissa = static_cast<std::uint64_t>(scaled);
+            auto fraction = scaled - mantissa;
+            if(fraction > 0.5 || (fraction == 0.5 && mantissa % 2 == 1)) ++mantissa; // ties to even, like printf
+            if(mantissa == high) {
+                mantissa = low;
+                ++exponent;
+            }
+            if(x < 0) *out++ = '-';
+
+            char digits[format_number_digits];
+            for(int i = format_number_digits - 1; i >= 0; --i) {
+                digits[i] = static_cast<char>('0' + mantissa % 10);
+                mantissa /= 10;
+            }
+            int n = format_number_digits;
+            while(n > 1 && digits[n - 1] == '0') --n;
+
+            if(exponent < -4 || exponent >= format_number_digits) {
+                *out++ = digits[0];
+                if(n > 1) {
+                    *out++ = '.';
+                    std::memcpy(out, digits + 1, n - 1);
+                    out += n - 1;
+                }
+                *out++ = 'e';
+                *out++ = exponent < 0 ? '-' : '+';
+                auto e = static_cast<std::uint64_t>(exponent < 0 ? -exponent : exponent);
+                if(e < 10) *out++ = '0';
+                return format_integer(e, out);
+            } else if(exponent < 0) {
+                *out++ = '0';
+                *out++ = '.';
+                for(int i = -1; i > exponent; --i) *out++ = '0';
+                std::memcpy(out, digits, n);
+                return out + n;
+            } else {
+                int whole = exponent + 1;
+                for(int i = 0; i < whole; ++i) *out++ = i < n ? digits[i] : '0';
+                if(n > whole) {
+                    *out++ = '.';
+                    std::memcpy(out, digits + whole, n - whole);
+                    out += n - whole;
+                }
+                return out;
+            }
+        }
+    } // namespace detail
+} // namespace nonius
+
+#endif // NONIUS_DETAIL_FORMAT_NUMBER_HPP
@@ -0,0 +1,241 @@
+// Nonius - C++ benchmarking tool
+//
+// Written in 2014- by the nonius contributors <nonius@rmf.io>
+//
+// To the extent possible under law, the author(s) have dedicated all copyright and related
+// and neighboring rights to this software to the public domain worldwide. This software is
+// distributed without any warranty.
+//
+// You should have received a copy of the CC0 Public Domain Dedication along with this software.
+// If not, see <http://creativecommons.org/publicdomain/zero/1.0/>
+
+// Measuring the effective CPU frequency
+
+#ifndef NONIUS_DETAIL_FREQUENCY_HPP
+#define NONIUS_DETAIL_FREQUENCY_HPP
+
+#include <nonius/clock.h++>
+#include <nonius/frequency_analysis.h++>
+#include <nonius/detail/compiler.h++>
+#include <nonius/detail/noexcept.h++>
+
+#if defined(__linux__)
+#   include <linux/perf_event.h>
+#   include <sys/syscall.h>
+#   include <unistd.h>
+#   define NONIUS_HAS_PERF_EVENTS
+#endif
+
+#if defined(NONIUS_GCC) || defined(NONIUS_CLANG)
+#   define NONIUS_HAS_SPIN_LOOP
+#endif
+
+#include <algorithm>
+#include <exception>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+namespace nonius {
+    struct frequency_measurement_unsupported : virtual std::exception {
+        char const* what() const NONIUS_NOEXCEPT override {
+            return "measuring the CPU frequency is not supported on this platform";
+        }
+    };
+
+    namespace detail {
+        const std::uint64_t spin_iterations = 1 << 16;
+        const double frequency_tolerance = 0.05; // samples this much slower than the median are degraded
+
+        // A dependent chain of additions: one cycle per iteration on current x86 and ARM cores.
+        inline void spin(std::uint64_t n) {
+#ifdef NONIUS_HAS_SPIN_LOOP
+            std::uint64_t x = 0;
+            for(std::uint64_t i = 0; i < n; ++i) {
+                asm volatile("" : "+r"(x));
+                ++x;
+            }
+#else
+            (void)n;
+#endif
+        }
+
+        template <typename Clock>
+        double spin_frequency() {
+            auto start = Clock::now();
+            spin(spin_iterations);
+            auto end = Clock::now();
+            auto elapsed = fp_seconds(end - start).count();
+            return elapsed > 0 ? spin_iterations / elapsed : 0.;
+        }
+
+        // The base frequency advertised by the frequency scaling driver or, when there is none and the
+        // frequency therefore does not change, the one in /proc/cpuinfo; zero if unknown.
+        inline double system_nominal_frequency() {
+            std::ifstream base("/sys/devices/system/cpu/cpu0/cpufreq/base_frequency");
+            double khz;
+            if(base >> khz) return khz * 1e3;
+            std::ifstream scaling("/sys/devices/system/cpu/cpu0/cpufreq/scaling_cur_freq");
+            if(scaling) return 0.;
+            std::ifstream cpuinfo("/proc/cpuinfo");
+            std::string line;
+            while(std::getline(cpuinfo, line)) {
+                if(line.compare(0, 7, "cpu MHz") != 0) continue;
+                auto colon = line.find(':');
+                if(colon == std::string::npos) break;
+                try {
+                    return std::stod(line.substr(colon + 1)) * 1e6;
+                } catch(std::exception const&) {
+                    break;
+                }
+            }
+            return 0.;
+        }
+
+#ifdef NONIUS_HAS_PERF_EVENTS
+        // A hardware counter for the calling thread, in user mode only.
+        struct perf_counter {
+            explicit perf_counter(std::uint64_t config) {
+                perf_event_attr attr;
+                std::memset(&attr, 0, sizeof(attr));
+                attr.size = sizeof(attr);
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = config;
+                attr.exclude_kernel = 1;
+                attr.exclude_hv = 1;
+                fd = static_cast<int>(::syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+                if(fd < 0) return;
+                spin(1024);
+                if(read() == 0) {
+                    // some virtual machines accept the event but never count anything
+                    ::close(fd);
+                    fd = -1;
+                }
+            }
+            perf_counter(perf_counter const&) = delete;
+            perf_counter& operator=(perf_counter const&) = delete;
+            ~perf_counter() {
+                if(fd >= 0) ::close(fd);
+            }
+
+            bool valid() const { return fd >= 0; }
+            std::uint64_t read() const {
+                std::uint64_t value = 0;
+                if(::read(fd, &value, sizeof(value)) != static_cast<ssize_t>(sizeof(value))) return 0;
+                return value;
+            }
+
+            int fd;
+        };
+#else
+        struct perf_counter {
+            explicit perf_counter(std::uint64_t) {}
+            bool valid() const { return false; }
+            std::uint64_t read() const { return 0; }
+        };
+#endif // NONIUS_HAS_PERF_EVENTS
+
+        struct frequency_readings {
+            frequency_source source = frequency_source::spin_loop;
+            double nominal = 0.; // Hz, or zero if unknown
+            std::vector<double> frequencies; // effective, in Hz, one per sample
+        };
+
+#ifdef NONIUS_HAS_PERF_EVENTS
+        const std::uint64_t perf_cycles = PERF_COUNT_HW_CPU_CYCLES;
+        const std::uint64_t perf_ref_cycles = PERF_COUNT_HW_REF_CPU_CYCLES;
+#else
+        const std::uint64_t perf_cycles = 0;
+        const std::uint64_t perf_ref_cycles = 0;
+#endif
+
+        // Counts the cycles of the timed regions of each sample when the hardware counters are
+        // available, or else runs a spin loop right before each sample to estimate the frequency.
+        // Reference cycles tick at the nominal frequency, so they tell it as well.
+        template <typename Clock>
+        struct frequency_meter {
+            frequency_meter()
+            : cycles(perf_cycles)
+            , ref_cycles(perf_ref_cycles) {
+#ifndef NONIUS_HAS_SPIN_LOOP
+                if(!cycles.valid()) throw frequency_measurement_unsupported();
+#endif
+                if(!ref_cycles.valid()) system_nominal = system_nominal_frequency();
+            }
+
+            // Called by the chronometer around each timed region.
+            void start() {
+                if(!cycles.valid()) return;
+                cycles_start = cycles.read();
+                if(ref_cycles.valid()) ref_cycles_start = ref_cycles.read();
+            }
+            void finish() {
+                if(!cycles.valid()) return;
+                sample_cycles += cycles.read() - cycles_start;
+                if(ref_cycles.valid()) sample_ref_cycles += ref_cycles.read() - ref_cycles_start;
+            }
+
+            void begin_sample() {
+                sample_cycles = 0;
+                sample_ref_cycles = 0;
+                if(!cycles.valid()) sample_frequency = spin_frequency<Clock>();
+            }
+            // Takes the raw time of the timed regions of the sample.
+            void end_sample(fp_seconds elapsed) {
+                if(cycles.valid()) {
+                    sample_frequency = elapsed.count() > 0 ? sample_cycles / elapsed.count() : 0.;
+                    total_ref_cycles += static_cast<double>(sample_ref_cycles);
+                    total_elapsed += elapsed;
+                }
+                frequencies.push_back(sample_frequency);
+            }
+
+            frequency_readings readings() const {
+                frequency_readings r;
+                r.source = cycles.valid() ? frequency_source::perf_counters : frequency_source::spin_loop;
+                r.nominal = ref_cycles.valid() && total_elapsed.count() > 0 ? total_ref_cycles / total_elapsed.count() : system_nominal;
+                r.frequencies = frequencies;
+                return r;
+            }
+
+            perf_counter cycles;
+            perf_counter ref_cycles;
+            std::uint64_t cycles_start = 0;
+            std::uint64_t ref_cycles_start = 0;
+            std::uint64_t sample_cycles = 0;
+            std::uint64_t sample_ref_cycles = 0;
+            double sample_frequency = 0.;
+            double total_ref_cycles = 0.;
+            fp_seconds total_elapsed = fp_seconds::zero();
+            double system_nominal = 0.;
+            std::vector<double> frequencies;
+        };
+
+        template <typename Duration>
+        frequency_analysis analyse_frequency(frequency_readings const& readings, std::vector<Duration> const& samples) {
+            frequency_analysis analysis;
+            analysis.source = readings.source;
+            analysis.nominal = readings.nominal;
+            analysis.frequencies = readings.frequencies;
+            if(readings.frequencies.size() != samples.size() || samples.empty()) return analysis;
+
+            std::vector<double> sorted(readings.frequencies);
+            std::nth_element(sorted.begin(), sorted.begin() + sorted.size() / 2, sorted.end());
+            auto median = sorted[sorted.size() / 2];
+
+            for(std::size_t i = 0; i < samples.size(); ++i) {
+                auto f = readings.frequencies[i];
+                auto cycles = fp_seconds(samples[i]).count() * f;
+                analysis.cycles.push_back(cycles);
+                if(readings.nominal > 0) analysis.normalized.push_back(fp_seconds(cycles / readings.nominal));
+                analysis.degraded.push_back(f < (1 - frequency_tolerance) * median);
+            }
+            return analysis;
+        }
+    } // namespace detail
+} // namespace nonius
+
+#endif // NONIUS_DETAIL_FREQUENCY_HPP
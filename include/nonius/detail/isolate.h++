@@ -0,0 +1,143 @@
+// Nonius - C++ benchmarking tool
+//
+// Written in 2014- by the nonius contributors <nonius@rmf.io>
+//
+// To the extent possible under law, the author(s) have dedicated all copyright and related
+// and neighboring rights to this software to the public domain worldwide. This software is
+// distributed without any warranty.
+//
+// You should have received a copy of the CC0 Public Domain Dedication along with this software.
+// If not, see <http://creativecommons.org/publicdomain/zero/1.0/>
+
+// Running benchmarks in a child process
+
+#ifndef NONIUS_DETAIL_ISOLATE_HPP
+#define NONIUS_DETAIL_ISOLATE_HPP
+
+#include <nonius/detail/noexcept.h++>
+
+#if defined(__unix__) || defined(__APPLE__)
+#   include <unistd.h>
+#   include <sys/types.h>
+#   include <sys/wait.h>
+#   include <signal.h>
+#   define NONIUS_HAS_FORK
+#endif
+
+#include <string>
+#include <vector>
+#include <exception>
+#include <type_traits>
+#include <cstdint>
+#include <cstddef>
+#include <cerrno>
+#include <cstring>
+
+namespace nonius {
+    struct isolation_unsupported : virtual std::exception {
+        char const* what() const NONIUS_NOEXCEPT override {
+            return "running benchmarks in isolation is not supported on this platform";
+        }
+    };
+
+    struct isolated_benchmark_error : virtual std::exception {
+        explicit isolated_benchmark_error(std::string message) : message(std::move(message)) {}
+
+        char const* what() const NONIUS_NOEXCEPT override {
+            return message.c_str();
+        }
+
+        std::string message;
+    };
+
+    namespace detail {
+        // Records sent from the child to the parent.
+        enum class isolated_record : char {
+            first_calls = 'C',
+            plan = 'P',
+            samples = 'S',
+            failure = 'F',
+        };
+
+#ifdef NONIUS_HAS_FORK
+        struct pipe_writer {
+            int fd;
+
+            void write(void const* data, std::size_t size) {
+                auto p = static_cast<char const*>(data);
+                while(size > 0) {
+                    auto n = ::write(fd, p, size);
+                    if(n < 0) {
+                        if(errno == EINTR) continue;
+                        return; // the parent is gone; nothing useful left to do
+                    }
+                    p += n;
+                    size -= static_cast<std::size_t>(n);
+                }
+            }
+            template <typename T>
+            void put(T const& value) {
+                static_assert(std::is_trivially_copyable<T>::value, "only trivial types go through the pipe");
+                write(&value, sizeof(value));
+            }
+            void put(std::string const& s) {
+                put(static_cast<std::uint32_t>(s.size()));
+                write(s.data(), s.size());
+            }
+            template <typename T>
+            void put(std::vector<T> const& v) {
+                put(static_cast<std::uint32_t>(v.size()));
+                write(v.data(), v.size() * sizeof(T));
+            }
+        };
+
+        struct pipe_reader {
+            int fd;
+
+            bool read(void* data, std::size_t size) {
+                auto p = static_cast<char*>(data);
+                while(size > 0) {
+                    auto n = ::read(fd, p, size);
+                    if(n < 0 && errno == EINTR) continue;
+                    if(n <= 0) return false;
+                    p += n;
+                    size -= static_cast<std::size_t>(n);
+                }
+                return true;
+            }
+            template <typename T>
+            bool get(T& value) {
+                static_assert(std::is_trivially_copyable<T>::value, "only trivial types go through the pipe");
+                return read(&value, sizeof(value));
+            }
+            bool get(std::string& s) {
+                std::uint32_t size;
+                if(!get(size)) return false;
+                s.resize(size);
+                return size == 0 || read(&s[0], size);
+            }
+            template <typename T>
+            bool get(std::vector<T>& v) {
+                std::uint32_t size;
+                if(!get(size)) return false;
+                v.resize(size);
+                return size == 0 || read(v.data(), size * sizeof(T));
+            }
+        };
+
+        // Describes how a child process ended when it did not send its results.
+        inline std::string child_status_message(int status) {
+            if(WIFSIGNALED(status)) {
+                auto sig = WTERMSIG(status);
+                return "benchmark crashed with signal " + std::to_string(sig) + " (" + ::strsignal(sig) + ")";
+            } else if(WIFEXITED(status)) {
+                return "benchmark process exited early with status " + std::to_string(WEXITSTATUS(status));
+            } else {
+                return "benchmark process ended abnormally";
+            }
+        }
+#endif // NONIUS_HAS_FORK
+    } // namespace detail
+} // namespace nonius
+
+#endif // NONIUS_DETAIL_ISOLATE_HPP
@@ -0,0 +1,64 @@
+// Nonius - C++ benchmarking tool
+//
+// Written in 2014- by the nonius contributors <nonius@rmf.io>
+//
+// To the extent possible under law, the author(s) have dedicated all copyright and related
+// and neighboring rights to this software to the public domain worldwide. This software is
+// distributed without any warranty.
+//
+// You should have received a copy of the CC0 Public Domain Dedication along with this software.
+// If not, see <http://creativecommons.org/publicdomain/zero/1.0/>
+
+// Writing JSON values
+
+#ifndef NONIUS_DETAIL_JSON_HPP
+#define NONIUS_DETAIL_JSON_HPP
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ostream>
+#include <string>
+
+namespace nonius {
+    namespace detail {
+        // Inside an HTML script element, '<' is escaped too, so that no string can end it.
+        inline void write_json_string(std::ostream& os, std::string const& s, bool in_script = false) {
+            os << '"';
+            for(auto c : s) {
+                switch(c) {
+                case '<': os << (in_script ? "\\u003c" : "<"); break;
+                case '"': os << "\\\""; break;
+                case '\\': os << "\\\\"; break;
+                case '\n': os << "\\n"; break;
+                case '\r': os << "\\r"; break;
+                case '\t': os << "\\t"; break;
+                default:
+                    if(static_cast<unsigned char>(c) < 0x20) {
+                        char escaped[7];
+                        std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(c));
+                        os << escaped;
+                    } else {
+                        os << c;
+                    }
+                }
+            }
+            os << '"';
+        }
+
+        // As few digits as read back to the same value; JSON has no infinities or NaNs, so
+        // those become null.
+        inline void write_json_number(std::ostream& os, double x) {
+            if(!std::isfinite(x)) {
+                os << "null";
+                return;
+            }
+            char buffer[32];
+            std::snprintf(buffer, sizeof(buffer), "%.15g", x);
+            if(std::strtod(buffer, nullptr) != x) std::snprintf(buffer, sizeof(buffer), "%.17g", x);
+            os << buffer;
+        }
+    } // namespace detail
+} // namespace nonius
+
+#endif // NONIUS_DETAIL_JSON_HPP
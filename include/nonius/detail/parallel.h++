@@ -0,0 +1,114 @@
+// Nonius - C++ benchmarking tool
+//
+// Written in 2014- by the nonius contributors <nonius@rmf.io>
+//
+// To the extent possible under law, the author(s) have dedicated all copyright and related
+// and neighboring rights to this software to the public domain worldwide. This software is
+// distributed without any warranty.
+//
+// You should have received a copy of the CC0 Public Domain Dedication along with this software.
+// If not, see <http://creativecommons.org/publicdomain/zero/1.0/>
+
+// Running several benchmarks at once on separate cores
+
+#ifndef NONIUS_DETAIL_PARALLEL_HPP
+#define NONIUS_DETAIL_PARALLEL_HPP
+
+#include <nonius/clock.h++>
+
+#if defined(__linux__)
+#   include <sched.h>
+#   define NONIUS_HAS_AFFINITY
+#endif
+
+#include <algorithm>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cstddef>
+
+namespace nonius {
+    // A benchmark that was run again on its own after running alongside others.
+    struct interference_check {
+        std::string benchmark;
+        fp_seconds parallel; // mean
+        fp_seconds serial; // mean
+    };
+
+    namespace detail {
+        const int max_interference_checks = 3;
+        const double interference_threshold = 0.05; // relative difference in the means worth a warning
+
+        // Parses lists in the format used by /sys/devices/system/cpu, like "0-3,8,10-11".
+        inline std::vector<int> parse_cpu_list(std::string const& s) {
+            std::vector<int> cpus;
+            std::istringstream ss(s);
+            std::string range;
+            while(std::getline(ss, range, ',')) {
+                int first, last;
+                char dash;
+                std::istringstream rs(range);
+                if(!(rs >> first)) continue;
+                if(rs >> dash >> last && dash == '-') {
+                    for(int cpu = first; cpu <= last; ++cpu) cpus.push_back(cpu);
+                } else {
+                    cpus.push_back(first);
+                }
+            }
+            return cpus;
+        }
+
+        inline std::string read_cpu_file(int cpu, std::string const& file) {
+            std::ifstream in("/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/" + file);
+            std::string line;
+            std::getline(in, line);
+            return line;
+        }
+
+        // Picks one logical CPU from each physical core the process may run on, or from each L3
+        // cache domain, and at most jobs of them. The other hardware threads of the chosen cores
+        // are left idle. Empty when the topology is unknown.
+        inline std::vector<int> job_cpus(int jobs, bool per_l3) {
+            std::vector<int> chosen;
+#ifdef NONIUS_HAS_AFFINITY
+            cpu_set_t allowed;
+            CPU_ZERO(&allowed);
+            if(::sched_getaffinity(0, sizeof(allowed), &allowed) != 0) return chosen;
+            std::set<std::string> taken;
+            for(int cpu = 0; cpu < CPU_SETSIZE && static_cast<int>(chosen.size()) < jobs; ++cpu) {
+                if(!CPU_ISSET(cpu, &allowed)) continue;
+                auto domain = read_cpu_file(cpu, per_l3 ? "cache/index3/shared_cpu_list" : "topology/thread_siblings_list");
+                if(domain.empty() && per_l3) domain = "package " + read_cpu_file(cpu, "topology/physical_package_id");
+                if(domain.empty()) domain = "cpu " + std::to_string(cpu);
+                if(taken.insert(domain).second) chosen.push_back(cpu);
+            }
+#else
+            (void)jobs; (void)per_l3;
+#endif
+            return chosen;
+        }
+
+        inline void pin_to_cpu(int cpu) {
+#ifdef NONIUS_HAS_AFFINITY
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(cpu, &set);
+            ::sched_setaffinity(0, sizeof(set), &set);
+#else
+            (void)cpu;
+#endif
+        }
+
+        // Spreads the checks evenly over the suite, always in the same places.
+        inline std::vector<std::size_t> interference_check_indices(std::size_t n) {
+            std::vector<std::size_t> indices;
+            auto k = std::min<std::size_t>(n, max_interference_checks);
+            for(std::size_t i = 0; i < k; ++i) indices.push_back(i * n / k);
+            return indices;
+        }
+    } // namespace detail
+} // namespace nonius
+
+#endif // NONIUS_DETAIL_PARALLEL_HPP
@@ -0,0 +1,171 @@
+// Nonius - C++ benchmarking tool
+//
+// Written in 2014- by the nonius contributors <nonius@rmf.io>
+//
+// To the extent possible under law, the author(s) have dedicated all copyright and related
+// and neighboring rights to this software to the public domain worldwide. This software is
+// distributed without any warranty.
+//
+// You should have received a copy of the CC0 Public Domain Dedication along with this software.
+// If not, see <http://creativecommons.org/publicdomain/zero/1.0/>
+
+// Persistent cache of iteration estimates
+
+#ifndef NONIUS_DETAIL_PLAN_CACHE_HPP
+#define NONIUS_DETAIL_PLAN_CACHE_HPP
+
+#include <nonius/clock.h++>
+#include <nonius/param.h++>
+
+#if defined(__unix__) || defined(__APPLE__)
+#   include <sys/types.h>
+#   include <sys/stat.h>
+#endif
+
+#include <algorithm>
+#include <istream>
+#include <map>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace nonius {
+    namespace detail {
+        // Identifies the running executable by size and modification time, so that estimates are
+        // not reused after a rebuild. Empty when unknown.
+        inline std::string binary_identity() {
+#if defined(__linux__)
+            struct stat st;
+            if(::stat("/proc/self/exe", &st) == 0) {
+                return std::to_string(st.st_size) + "-" + std::to_string(st.st_mtime);
+            }
+#endif
+            return {};
+        }
+
+        // Parameters in a canonical order, as a single line.
+        inline std::string params_key(parameters const& params) {
+            std::vector<std::pair<std::string, std::string>> entries;
+            for(auto&& p : params) {
+                std::ostringstream ss;
+                ss << p.second;
+                entries.emplace_back(p.first, ss.str());
+            }
+            std::sort(entries.begin(), entries.end());
+            std::string key;
+            for(auto&& e : entries) {
+                if(!key.empty()) key += ';';
+                key += e.first + '=' + e.second;
+            }
+            return key;
+        }
+
+        inline std::string escape_field(std::string const& s) {
+            std::string r;
+            for(auto c : s) {
+                switch(c) {
+                case '\\': r += "\\\\"; break;
+                case '\t': r += "\\t"; break;
+                case '\n': r += "\\n"; break;
+                default: r += c;
+                }
+            }
+            return r;
+        }
+        inline std::vector<std::string> split_fields(std::string const& line) {
+            std::vector<std::string> fields(1);
+            for(std::size_t i = 0; i < line.size(); ++i) {
+                if(line[i] == '\t') {
+                    fields.emplace_back();
+                } else if(line[i] == '\\' && i + 1 < line.size()) {
+                    auto c = line[++i];
+                    fields.back() += c == 't' ? '\t' : c == 'n' ? '\n' : c;
+                } else {
+                    fields.back() += line[i];
+                }
+            }
+            return fields;
+        }
+
+        struct cached_plan {
+            int iterations;
+            fp_seconds iteration_time;
+        };
+
+        // Estimates keyed by benchmark name, parameters and binary. When pinned, estimates are
+        // reused regardless of the binary and never replaced.
+        struct plan_cache {
+            plan_cache(std::string binary, bool pinned) : binary(std::move(binary)), pinned(pinned) {}
+
+            cached_plan const* find(std::string const& name, parameters const& params) const {
+                auto key = params_key(params);
+                auto it = entries.find(std::make_tuple(name, key, binary));
+                if(it != entries.end()) return &it->second;
+                if(!pinned) return nullptr;
+                it = entries.lower_bound(std::make_tuple(name, key, std::string()));
+                if(it != entries.end() && std::get<0>(it->first) == name && std::get<1>(it->first) == key) return &it->second;
+                return nullptr;
+            }
+
+            // An estimate from any binary, picked the same way by everyone reading the same file.
+            cached_plan const* find_any(std::string const& name, parameters const& params) const {
+                auto key = params_key(params);
+                auto it = entries.lower_bound(std::make_tuple(name, key, std::string()));
+                if(it != entries.end() && std::get<0>(it->first) == name && std::get<1>(it->first) == key) return &it->second;
+                return nullptr;
+            }
+
+            void insert(std::string const& name, parameters const& params, cached_plan plan) {
+                if(pinned && find(name, params)) return;
+                entries[std::make_tuple(name, params_key(params), binary)] = plan;
+            }
+
+            // One estimate per line: binary, name, parameters, iterations, seconds per iteration.
+            // Unless pinned, only one estimate is kept for each name and parameters: the one for
+            // this binary if any, else the one find_any picks, so that old builds do not pile up.
+            void load(std::istream& is) {
+                std::string line;
+                while(std::getline(is, line)) {
+                    auto fields = split_fields(line);
+                    if(fields.size() != 5) continue;
+                    try {
+                        cached_plan plan { std::stoi(fields[3]), fp_seconds(std::stod(fields[4])) };
+                        if(plan.iterations > 0) entries[std::make_tuple(fields[1], fields[2], fields[0])] = plan;
+                    } catch(std::exception const&) {} // skip garbage
+                }
+            }
+            void save(std::ostream& os) const {
+                os.precision(17);
+                for(auto&& e : entries) {
+                    if(!pinned && superseded(e.first)) continue;
+                    os << escape_field(std::get<2>(e.first)) << '\t'
+                       << escape_field(std::get<0>(e.first)) << '\t'
+                       << escape_field(std::get<1>(e.first)) << '\t'
+                       << e.second.iterations << '\t'
+                       << e.second.iteration_time.count() << '\n';
+                }
+            }
+
+            std::size_t size() const { return entries.size(); }
+
+        private:
+            using key_type = std::tuple<std::string, std::string, std::string>;
+
+            bool superseded(key_type const& key) const {
+                if(std::get<2>(key) == binary) return false;
+                if(entries.count(std::make_tuple(std::get<0>(key), std::get<1>(key), binary))) return true;
+                auto first = entries.lower_bound(std::make_tuple(std::get<0>(key), std::get<1>(key), std::string()));
+                return first->first != key;
+            }
+
+            std::string binary;
+            bool pinned;
+            std::map<key_type, cached_plan> entries;
+        };
+    } // namespace detail
+} // namespace nonius
+
+#endif // NONIUS_DETAIL_PLAN_CACHE_HPP
@@ -0,0 +1,75 @@
+// Nonius - C++ benchmarking tool
+//
+// Written in 2014- by the nonius contributors <nonius@rmf.io>
+//
+// To the extent possible under law, the author(s) have dedicated all copyright and related
+// and neighboring rights to this software to the public domain worldwide. This software is
+// distributed without any warranty.
+//
+// You should have received a copy of the CC0 Public Domain Dedication along with this software.
+// If not, see <http://creativecommons.org/publicdomain/zero/1.0/>
+
+// Storage for the results of per-iteration setup
+
+#ifndef NONIUS_DETAIL_SETUP_BATCH_HPP
+#define NONIUS_DETAIL_SETUP_BATCH_HPP
+
+#include <nonius/detail/cache_flush.h++>
+
+#include <algorithm>
+#include <new>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+
+namespace nonius {
+    namespace detail {
+        // Upper bound on the memory taken by the setup results themselves; longer runs are split in
+        // chunks. Memory owned by the results is not counted.
+        const std::size_t max_setup_batch_bytes = std::size_t(16) << 20;
+
+        inline int setup_batch_capacity(std::size_t object_size, int runs, int batch_size = 0) {
+            auto fitting = std::max<std::size_t>(1, max_setup_batch_bytes / object_size);
+            if(batch_size > 0) fitting = std::min<std::size_t>(fitting, static_cast<std::size_t>(batch_size));
+            return static_cast<int>(std::min<std::size_t>(fitting, static_cast<std::size_t>(runs)));
+        }
+
+        // Contiguous objects starting on a cache line boundary, constructed and destroyed outside
+        // of the timed region.
+        template <typename T>
+        struct setup_batch {
+            static constexpr std::size_t alignment = alignof(T) > cache_line_size ? alignof(T) : cache_line_size;
+
+            explicit setup_batch(int capacity)
+            : raw(::operator new(capacity * sizeof(T) + alignment)) {
+                auto address = reinterpret_cast<std::uintptr_t>(raw);
+                objects = reinterpret_cast<T*>((address + alignment - 1) / alignment * alignment);
+            }
+            setup_batch(setup_batch const&) = delete;
+            setup_batch& operator=(setup_batch const&) = delete;
+            ~setup_batch() {
+                clear();
+                ::operator delete(raw);
+            }
+
+            template <typename... Args>
+            void emplace_back(Args&&... args) {
+                new(objects + count) T(std::forward<Args>(args)...);
+                ++count;
+            }
+            void clear() {
+                while(count > 0) objects[--count].~T();
+            }
+
+            T& operator[](int i) { return objects[i]; }
+            int size() const { return count; }
+
+        private:
+            void* raw;
+            T* objects;
+            int count = 0;
+        };
+    } // namespace detail
+} // namespace nonius
+
+#endif // NONIUS_DETAIL_SETUP_BATCH_HPP
@@ -0,0 +1,86 @@
+// Nonius - C++ benchmarking tool
+//
+// Written in 2014- by the nonius contributors <nonius@rmf.io>
+//
+// To the extent possible under law, the author(s) have dedicated all copyright and related
+// and neighboring rights to this software to the public domain worldwide. This software is
+// distributed without any warranty.
+//
+// You should have received a copy of the CC0 Public Domain Dedication along with this software.
+// If not, see <http://creativecommons.org/publicdomain/zero/1.0/>
+
+// Splitting a suite across machines
+
+#ifndef NONIUS_DETAIL_SHARD_HPP
+#define NONIUS_DETAIL_SHARD_HPP
+
+#include <nonius/clock.h++>
+#include <nonius/configuration.h++>
+#include <nonius/param.h++>
+#include <nonius/detail/plan_cache.h++>
+
+#include <algorithm>
+#include <numeric>
+#include <string>
+#include <vector>
+#include <cstddef>
+
+namespace nonius {
+    struct shard_plan {
+        int index; // counting from one
+        int count;
+        std::vector<std::string> benchmarks; // the whole suite, in order
+        int rounds; // sets of parameters
+        std::vector<int> assignment; // shard of each benchmark in each round, round after round
+        fp_seconds estimated; // for this shard, or zero if nothing is known
+    };
+
+    namespace detail {
+        // Longest processing time first: the most expensive remaining benchmark goes to the shard
+        // with the least work so far. Ties go to the lowest index, so every shard gets the same
+        // answer.
+        inline std::vector<int> assign_shards(std::vector<double> const& costs, int count) {
+            std::vector<std::size_t> order(costs.size());
+            std::iota(order.begin(), order.end(), std::size_t(0));
+            std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) { return costs[a] > costs[b]; });
+
+            std::vector<double> load(count, 0.);
+            std::vector<int> assignment(costs.size(), 0);
+            for(auto i : order) {
+                auto lightest = std::min_element(load.begin(), load.end()) - load.begin();
+                assignment[i] = static_cast<int>(lightest) + 1;
+                load[lightest] += costs[i];
+            }
+            return assignment;
+        }
+
+        // Costs come from the plan cache, which should be the same file on every machine; the
+        // benchmarks it does not know are assumed to cost as much as the average known one.
+        inline shard_plan plan_shards(configuration const& cfg, std::vector<std::string> const& names, std::vector<parameters> const& all_params, plan_cache const* plans) {
+            std::vector<double> costs;
+            std::vector<bool> known;
+            for(auto&& params : all_params) {
+                for(auto&& name : names) {
+                    auto cached = plans ? plans->find_any(name, params) : nullptr;
+                    costs.push_back(cached ? cached->iterations * cached->iteration_time.count() * cfg.samples : 0.);
+                    known.push_back(cached != nullptr);
+                }
+            }
+            auto n_known = std::count(known.begin(), known.end(), true);
+            auto average = n_known > 0 ? std::accumulate(costs.begin(), costs.end(), 0.) / n_known : 1.;
+            for(std::size_t i = 0; i < costs.size(); ++i) {
+                if(!known[i]) costs[i] = average;
+            }
+
+            shard_plan plan { cfg.shard.index, cfg.shard.count, names, static_cast<int>(all_params.size()), assign_shards(costs, cfg.shard.count), fp_seconds::zero() };
+            if(n_known > 0) {
+                for(std::size_t i = 0; i < costs.size(); ++i) {
+                    if(plan.assignment[i] == plan.index) plan.estimated += fp_seconds(costs[i]);
+                }
+            }
+            return plan;
+        }
+    } // namespace detail
+} // namespace nonius
+
+#endif // NONIUS_DETAIL_SHARD_HPP
@@ -27,6 +27,7 @@
 #include <numeric>
 #include <tuple>
 #include <cmath>
+#include <limits>
 #include <utility>
 #include <future>
 
@@ -162,6 +163,33 @@ namespace nonius {
             return { point, resample[lo], resample[hi], confidence_level };
         }
 
+        // Mean and variance updated one sample at a time (Welford's method).
+        struct running_stats {
+            void add(double x) {
+                ++n;
+                auto d = x - m;
+                m += d / n;
+                m2 += d * (x - m);
+            }
+
+            int count() const { return n; }
+            double mean() const { return m; }
+            double variance() const { return n > 1 ? m2 / (n - 1) : 0.; }
+
+            // Half-width of the normal approximation confidence interval for the mean, relative to it.
+            double relative_ci_half_width(double confidence_level) const {
+                namespace bm = boost::math;
+                if(n < 2 || m <= 0) return std::numeric_limits<double>::infinity();
+                auto z = bm::quantile(bm::normal{}, (1. + confidence_level) / 2.);
+                return z * std::sqrt(variance() / n) / m;
+            }
+
+        private:
+            int n = 0;
+            double m = 0.;
+            double m2 = 0.;
+        };
+
         inline double outlier_variance(estimate<double> mean, estimate<double> stddev, int n) {
             double sb = stddev.point;
             double mn = mean.point / n;
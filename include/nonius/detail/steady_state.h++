@@ -0,0 +1,93 @@
+// Nonius - C++ benchmarking tool
+//
+// Written in 2014- by the nonius contributors <nonius@rmf.io>
+//
+// To the extent possible under law, the author(s) have dedicated all copyright and related
+// and neighboring rights to this software to the public domain worldwide. This software is
+// distributed without any warranty.
+//
+// You should have received a copy of the CC0 Public Domain Dedication along with this software.
+// If not, see <http://creativecommons.org/publicdomain/zero/1.0/>
+
+// Steady state detection
+
+#ifndef NONIUS_DETAIL_STEADY_STATE_HPP
+#define NONIUS_DETAIL_STEADY_STATE_HPP
+
+#include <algorithm>
+#include <deque>
+#include <cmath>
+
+namespace nonius {
+    namespace detail {
+        const int steady_state_window = 20;
+        const double steady_state_max_drift = 0.02;         // change across the window, relative to the mean
+        const double steady_state_trend_significance = 2.;  // t statistic of the slope
+        const double steady_state_max_variance_ratio = 4.;  // between the two halves of the window
+
+        // Watches the most recent timings and tells when they show neither a trend nor a change in spread.
+        struct steady_state_detector {
+            explicit steady_state_detector(int window = steady_state_window) : window(std::max(window, 4)) {}
+
+            void add(double x) {
+                timings.push_back(x);
+                if(static_cast<int>(timings.size()) > window) timings.pop_front();
+            }
+
+            bool steady() const {
+                if(static_cast<int>(timings.size()) < window) return false;
+                return !trending() && stable_spread();
+            }
+
+        private:
+            double mean(std::size_t first, std::size_t last) const {
+                double sum = 0.;
+                for(auto i = first; i < last; ++i) sum += timings[i];
+                return sum / (last - first);
+            }
+            double variance(std::size_t first, std::size_t last) const {
+                auto m = mean(first, last);
+                double sum = 0.;
+                for(auto i = first; i < last; ++i) sum += (timings[i] - m) * (timings[i] - m);
+                return sum / (last - first - 1);
+            }
+
+            // A trend counts only if it is both significant and large enough to matter.
+            bool trending() const {
+                auto n = timings.size();
+                auto xm = (n - 1) / 2.;
+                auto ym = mean(0, n);
+                double sxx = 0., sxy = 0.;
+                for(std::size_t i = 0; i < n; ++i) {
+                    sxx += (i - xm) * (i - xm);
+                    sxy += (i - xm) * (timings[i] - ym);
+                }
+                auto slope = sxy / sxx;
+                auto drift = std::abs(slope) * (n - 1);
+                if(drift <= steady_state_max_drift * std::abs(ym)) return false;
+
+                double sse = 0.;
+                for(std::size_t i = 0; i < n; ++i) {
+                    auto r = timings[i] - (ym + slope * (i - xm));
+                    sse += r * r;
+                }
+                auto se = std::sqrt(sse / (n - 2) / sxx);
+                return se == 0. || std::abs(slope) / se > steady_state_trend_significance;
+            }
+
+            bool stable_spread() const {
+                auto n = timings.size();
+                auto floor = 1e-6 * mean(0, n) * mean(0, n); // clock granularity makes tiny variances meaningless
+                auto a = variance(0, n / 2) + floor;
+                auto b = variance(n / 2, n) + floor;
+                if(a == 0. || b == 0.) return a == b;
+                return std::max(a, b) / std::min(a, b) <= steady_state_max_variance_ratio;
+            }
+
+            int window;
+            std::deque<double> timings;
+        };
+    } // namespace detail
+} // namespace nonius
+
+#endif // NONIUS_DETAIL_STEADY_STATE_HPP
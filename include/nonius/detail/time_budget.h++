@@ -0,0 +1,77 @@
+// Nonius - C++ benchmarking tool
+//
+// Written in 2014- by the nonius contributors <nonius@rmf.io>
+//
+// To the extent possible under law, the author(s) have dedicated all copyright and related
+// and neighboring rights to this software to the public domain worldwide. This software is
+// distributed without any warranty.
+//
+// You should have received a copy of the CC0 Public Domain Dedication along with this software.
+// If not, see <http://creativecommons.org/publicdomain/zero/1.0/>
+
+// Fitting a suite into a time budget
+
+#ifndef NONIUS_DETAIL_TIME_BUDGET_HPP
+#define NONIUS_DETAIL_TIME_BUDGET_HPP
+
+#include <nonius/clock.h++>
+#include <nonius/detail/noexcept.h++>
+
+#include <algorithm>
+#include <exception>
+#include <numeric>
+#include <vector>
+#include <cstddef>
+
+namespace nonius {
+    struct time_budget_exceeded : virtual std::exception {
+        char const* what() const NONIUS_NOEXCEPT override {
+            return "skipped: the benchmark does not fit in the time budget";
+        }
+    };
+
+    struct time_budget_plan {
+        fp_seconds budget;
+        fp_seconds estimated; // for everything that is left after planning
+        int samples;
+        int skipped;
+    };
+
+    namespace detail {
+        const int min_budget_samples = 10;
+        const double budget_margin = 0.05; // fraction of the budget kept for reporting and other slack
+        const double bootstrap_cost_per_sample = 5e-8; // rough seconds per sample per resample
+
+        struct budget_allocation {
+            int samples;
+            std::vector<bool> skipped;
+        };
+
+        // Picks the number of samples that every benchmark gets so that they all fit in the time
+        // available, skipping the most expensive ones when not even min_samples would fit.
+        inline budget_allocation allocate_budget(std::vector<double> const& sample_costs, std::vector<double> const& overheads, double available, int samples, int min_samples) {
+            min_samples = std::min(min_samples, samples);
+            budget_allocation a { samples, std::vector<bool>(sample_costs.size(), false) };
+
+            std::vector<std::size_t> by_cost(sample_costs.size());
+            std::iota(by_cost.begin(), by_cost.end(), std::size_t(0));
+            std::stable_sort(by_cost.begin(), by_cost.end(), [&](std::size_t x, std::size_t y) { return sample_costs[x] > sample_costs[y]; });
+
+            for(std::size_t dropped = 0; ; ++dropped) {
+                double cost = 0, overhead = 0;
+                for(std::size_t i = 0; i < sample_costs.size(); ++i) {
+                    if(a.skipped[i]) continue;
+                    cost += sample_costs[i];
+                    overhead += overheads[i];
+                }
+                auto left = std::max(available - overhead, 0.);
+                a.samples = cost > 0 ? static_cast<int>(std::min<double>(samples, left / cost)) : samples;
+                if(a.samples >= min_samples || dropped == by_cost.size()) break;
+                a.skipped[by_cost[dropped]] = true;
+            }
+            return a;
+        }
+    } // namespace detail
+} // namespace nonius
+
+#endif // NONIUS_DETAIL_TIME_BUDGET_HPP
@@ -0,0 +1,28 @@
+// Nonius - C++ benchmarking tool
+//
+// Written in 2014- by the nonius contributors <nonius@rmf.io>
+//
+// To the extent possible under law, the author(s) have dedicated all copyright and related
+// and neighboring rights to this software to the public domain worldwide. This software is
+// distributed without any warranty.
+//
+// You should have received a copy of the CC0 Public Domain Dedication along with this software.
+// If not, see <http://creativecommons.org/publicdomain/zero/1.0/>
+
+// Drift of samples over time
+
+#ifndef NONIUS_DRIFT_ANALYSIS_HPP
+#define NONIUS_DRIFT_ANALYSIS_HPP
+
+namespace nonius {
+    struct drift_analysis {
+        double trend_z = 0.;    // Mann-Kendall statistic
+        double trend_p = 1.;    // two-sided p-value of the trend
+        double trend = 0.;      // change over the whole run along a fitted line, relative to the mean
+        int change_point = -1;  // first sample after a change in level, or -1 if none
+        double shift = 0.;      // change in the mean at the change point, relative to the mean before
+        bool stationary = true;
+    };
+} // namespace nonius
+
+#endif // NONIUS_DRIFT_ANALYSIS_HPP
@@ -33,7 +33,7 @@ namespace nonius {
         using clock_type = Clock;
         environment_estimate<FloatDuration<Clock>> clock_resolution;
         environment_estimate<FloatDuration<Clock>> clock_cost;
-        //estimate function_cost;
+        environment_estimate<FloatDuration<Clock>> function_cost; // per sample, not counting the clock
     };
 } // namespace nonius
 
@@ -15,49 +15,119 @@
 #define NONIUS_EXECUTION_PLAN_HPP
 
 #include <nonius/clock.h++>
+#include <nonius/configuration.h++>
 #include <nonius/environment.h++>
 #include <nonius/optimizer.h++>
 #include <nonius/detail/benchmark_function.h++>
-#include <nonius/detail/repeat.h++>
-#include <nonius/detail/run_for_at_least.h++>
+#include <nonius/detail/stats.h++>
+#include <nonius/detail/steady_state.h++>
 
 #include <vector>
 #include <iterator>
 #include <algorithm>
 
 namespace nonius {
+    namespace detail {
+        const int adaptive_batch_size = 10;
+        const int max_adaptive_samples = 10000;
+
+        // The time a measurement spends outside the user code: a clock call for every timed region,
+        // and the function cost, which is measured through the virtual interface that static
+        // benchmarks do not pay for in the timed region.
+        template <typename Clock>
+        FloatDuration<Clock> measurement_overhead(chronometer_model<Clock> const& model, environment<FloatDuration<Clock>> const& env) {
+            auto clock_cost = env.clock_cost.mean * std::max(model.regions, 1);
+            return model.direct ? clock_cost : clock_cost + env.function_cost.mean;
+        }
+    } // namespace detail
+
     template <typename Duration>
     struct execution_plan {
         int iterations_per_sample;
         Duration estimated_duration;
         parameters params;
         detail::benchmark_function benchmark;
-        Duration warmup_time;
-        int warmup_iterations;
+        Duration warmup_time; // upper bound
+        int warmup_window; // samples
 
         template <typename Duration2>
         operator execution_plan<Duration2>() const {
-            return { iterations_per_sample, estimated_duration, params, benchmark, warmup_time, warmup_iterations };
+            return { iterations_per_sample, estimated_duration, params, benchmark, warmup_time, warmup_window };
         }
 
         template <typename Clock>
         std::vector<FloatDuration<Clock>> run(configuration cfg, environment<FloatDuration<Clock>> env) const {
-            // warmup a bit
-            detail::run_for_at_least<Clock>(params, chrono::duration_cast<nonius::Duration<Clock>>(warmup_time), warmup_iterations, detail::repeat(now<Clock>{}));
+            warmup<Clock>();
+            return collect<Clock>(cfg, env);
+        }
 
+        // Takes samples of the benchmark until their timings reach a steady state, or until the
+        // warmup time runs out; returns the number of samples taken.
+        template <typename Clock>
+        int warmup() const {
+            detail::steady_state_detector detector(warmup_window);
+            auto deadline = Clock::now() + chrono::duration_cast<nonius::Duration<Clock>>(warmup_time);
+            int samples = 0;
+            do {
+                detail::chronometer_model<Clock> model;
+                detail::optimizer_barrier();
+                benchmark(chronometer(model, iterations_per_sample, params));
+                detail::optimizer_barrier();
+                detector.add(fp_seconds(model.elapsed()).count());
+                ++samples;
+            } while(!detector.steady() && Clock::now() < deadline);
+            return samples;
+        }
+
+        // Optionally records when each sample started, relative to the first one, and the
+        // frequency the CPU ran at.
+        template <typename Clock>
+        std::vector<FloatDuration<Clock>> collect(configuration cfg, environment<FloatDuration<Clock>> env, std::vector<fp_seconds>* starts = nullptr, detail::frequency_meter<Clock>* frequency = nullptr) const {
+            if(cfg.target_rel_ci > 0) return collect_adaptive<Clock>(cfg, env, starts, frequency);
             std::vector<FloatDuration<Clock>> times;
             times.reserve(cfg.samples);
-            std::generate_n(std::back_inserter(times), cfg.samples, [this, env]{
-                    detail::chronometer_model<Clock> model;
-                    detail::optimizer_barrier();
-                    this->benchmark(chronometer(model, iterations_per_sample, params));
-                    detail::optimizer_barrier();
-                    auto sample_time = model.elapsed() - env.clock_cost.mean;
-                    if(sample_time < FloatDuration<Clock>::zero()) sample_time = FloatDuration<Clock>::zero();
-                    return sample_time / iterations_per_sample;
+            auto origin = Clock::now();
+            std::generate_n(std::back_inserter(times), cfg.samples, [this, &cfg, &env, starts, frequency, origin]{
+                    if(starts) starts->push_back(Clock::now() - origin);
+                    return this->template sample<Clock>(cfg, env, frequency);
             });
             return times;
         }
+
+        // Takes samples in batches until the mean is known precisely enough, or time runs out.
+        template <typename Clock>
+        std::vector<FloatDuration<Clock>> collect_adaptive(configuration cfg, environment<FloatDuration<Clock>> env, std::vector<fp_seconds>* starts = nullptr, detail::frequency_meter<Clock>* frequency = nullptr) const {
+            std::vector<FloatDuration<Clock>> times;
+            detail::running_stats stats;
+            auto origin = Clock::now();
+            auto deadline = origin + chrono::duration_cast<nonius::Duration<Clock>>(fp_seconds(cfg.max_time));
+            while(static_cast<int>(times.size()) < detail::max_adaptive_samples) {
+                for(int i = 0; i < detail::adaptive_batch_size; ++i) {
+                    if(starts) starts->push_back(Clock::now() - origin);
+                    times.push_back(sample<Clock>(cfg, env, frequency));
+                    stats.add(times.back().count());
+                }
+                if(stats.relative_ci_half_width(cfg.confidence_interval) <= cfg.target_rel_ci) break;
+                if(Clock::now() >= deadline) break;
+            }
+            return times;
+        }
+
+        // Takes a single sample, as the time per iteration.
+        template <typename Clock>
+        FloatDuration<Clock> sample(configuration const& cfg, environment<FloatDuration<Clock>> const& env, detail::frequency_meter<Clock>* frequency = nullptr) const {
+            detail::chronometer_model<Clock> model;
+            model.flush_caches = cfg.cache != cache_mode::warm;
+            model.frequency = frequency;
+            if(frequency) frequency->begin_sample();
+            detail::optimizer_barrier();
+            benchmark(chronometer(model, iterations_per_sample, params));
+            detail::optimizer_barrier();
+            if(frequency) frequency->end_sample(model.elapsed());
+            auto sample_time = model.elapsed() - detail::measurement_overhead(model, env);
+            if(sample_time < FloatDuration<Clock>::zero()) sample_time = FloatDuration<Clock>::zero();
+            return sample_time / iterations_per_sample;
+        }
     };
 } // namespace nonius
 
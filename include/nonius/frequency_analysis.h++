@@ -0,0 +1,37 @@
+// Nonius - C++ benchmarking tool
+//
+// Written in 2014- by the nonius contributors <nonius@rmf.io>
+//
+// To the extent possible under law, the author(s) have dedicated all copyright and related
+// and neighboring rights to this software to the public domain worldwide. This software is
+// distributed without any warranty.
+//
+// You should have received a copy of the CC0 Public Domain Dedication along with this software.
+// If not, see <http://creativecommons.org/publicdomain/zero/1.0/>
+
+// Effective CPU frequency during the samples
+
+#ifndef NONIUS_FREQUENCY_ANALYSIS_HPP
+#define NONIUS_FREQUENCY_ANALYSIS_HPP
+
+#include <nonius/clock.h++>
+
+#include <vector>
+
+namespace nonius {
+    enum class frequency_source : char {
+        perf_counters = 'p', // cycles counted by the hardware
+        spin_loop = 's', // rate of a spin loop run right before each sample
+    };
+
+    struct frequency_analysis {
+        frequency_source source = frequency_source::spin_loop;
+        double nominal = 0.; // Hz, or zero if unknown
+        std::vector<double> frequencies; // effective, in Hz, one per sample
+        std::vector<double> cycles; // per iteration, one per sample
+        std::vector<fp_seconds> normalized; // per iteration at the nominal frequency; empty if that is unknown
+        std::vector<bool> degraded; // taken at a clearly lower frequency than most samples
+    };
+} // namespace nonius
+
+#endif // NONIUS_FREQUENCY_ANALYSIS_HPP
@@ -19,11 +19,21 @@
 #include <nonius/configuration.h++>
 #include <nonius/environment.h++>
 #include <nonius/reporter.h++>
+#include <nonius/resource_usage.h++>
 #include <nonius/reporters/standard_reporter.h++>
 #include <nonius/detail/estimate_clock.h++>
 #include <nonius/detail/analyse.h++>
+#include <nonius/detail/allocation_counters.h++>
 #include <nonius/detail/complete_invoke.h++>
 #include <nonius/detail/noexcept.h++>
+#include <nonius/detail/isolate.h++>
+#include <nonius/detail/plan_cache.h++>
+#include <nonius/detail/environment_cache.h++>
+#include <nonius/detail/time_budget.h++>
+#include <nonius/detail/drift.h++>
+#include <nonius/detail/frequency.h++>
+#include <nonius/detail/parallel.h++>
+#include <nonius/detail/shard.h++>
 
 #include <algorithm>
 #include <unordered_map>
@@ -32,10 +42,20 @@
 #include <set>
 #include <iterator>
 #include <functional>
+#include <numeric>
+#include <random>
 #include <exception>
 #include <utility>
 #include <regex>
+#include <iostream>
+#include <fstream>
+#include <memory>
+#include <system_error>
+#include <thread>
+#include <cstdio>
+#include <cerrno>
 #include <cstddef>
+#include <cstdint>
 
 namespace nonius {
     namespace detail {
@@ -53,7 +73,34 @@ namespace nonius {
             auto cost = detail::estimate_clock_cost<Clock>(resolution.mean);
             rep.estimate_clock_cost_complete(cost);
 
-            return { resolution, cost };
+            rep.estimate_function_cost_start();
+            auto function_cost = detail::estimate_function_cost<Clock>(cost.mean);
+            rep.estimate_function_cost_complete(function_cost);
+
+            return { resolution, cost, function_cost };
+        }
+
+        // Reuses a recent enough estimate for this host and clock from the environment cache, if
+        // one is configured, or measures and stores a new one.
+        template <typename Clock>
+        environment<FloatDuration<Clock>> measure_environment(configuration const& cfg, reporter& rep) {
+            if(cfg.env_cache.empty()) return measure_environment<Clock>(rep);
+
+            auto key = environment_cache_key<Clock>();
+            auto now = chrono::duration_cast<fp_seconds>(chrono::system_clock::now().time_since_epoch()).count();
+            environment<fp_seconds> cached;
+            std::ifstream in(cfg.env_cache);
+            if(in && find_cached_environment(in, key, now, cfg.env_cache_expiry.count(), cached)) {
+                rep.environment_reused();
+                rep.estimate_clock_resolution_complete(cached.clock_resolution);
+                rep.estimate_clock_cost_complete(cached.clock_cost);
+                rep.estimate_function_cost_complete(cached.function_cost);
+                return { cached.clock_resolution, cached.clock_cost, cached.function_cost };
+            }
+
+            auto env = measure_environment<Clock>(rep);
+            store_environment(cfg.env_cache, key, now, env);
+            return env;
         }
     } // namespace detail
 
@@ -73,6 +120,540 @@ namespace nonius {
         }
     }
 
+    namespace detail {
+        template <typename Duration>
+        struct benchmark_measurement {
+            std::vector<Duration> samples;
+            std::vector<fp_seconds> starts;
+            allocation_stats allocations;
+            resource_usage usage;
+            frequency_readings frequency;
+        };
+
+        template <typename Clock>
+        benchmark_measurement<FloatDuration<Clock>> measure_benchmark(configuration const& cfg, environment<FloatDuration<Clock>> env, execution_plan<FloatDuration<Clock>> const& plan) {
+            benchmark_measurement<FloatDuration<Clock>> m;
+            std::unique_ptr<frequency_meter<Clock>> frequency;
+            if(cfg.frequency) frequency.reset(new frequency_meter<Clock>());
+            plan.template warmup<Clock>();
+            reset_allocation_counters();
+            auto usage_before = current_resource_usage();
+            m.samples = plan.template collect<Clock>(cfg, env, &m.starts, frequency.get());
+            auto usage_after = current_resource_usage();
+            m.usage = resource_usage_delta(usage_before, usage_after);
+            if(frequency) m.frequency = frequency->readings();
+            m.allocations = allocation_snapshot(static_cast<std::uint64_t>(m.samples.size()) * plan.iterations_per_sample);
+            return m;
+        }
+
+        template <typename Duration>
+        void report_measurement(configuration const& cfg, environment<Duration> env, benchmark_measurement<Duration> const& m, reporter& rep) {
+            rep.measurement_complete(std::vector<fp_seconds>(m.samples.begin(), m.samples.end()));
+            if(m.starts.size() == m.samples.size()) rep.sample_starts_complete(m.starts);
+            if(resource_usage_available()) rep.resource_usage_complete(m.usage);
+            if(!m.frequency.frequencies.empty()) rep.frequency_complete(analyse_frequency(m.frequency, m.samples));
+            if(allocation_tracking_enabled()) rep.allocations_complete(m.allocations);
+
+            if(!cfg.no_analysis) {
+                rep.analysis_start();
+                auto analysis = detail::analyse(cfg, env, m.samples.begin(), m.samples.end());
+                rep.analysis_complete(analysis);
+                if(m.starts.size() == m.samples.size()) rep.drift_analysis_complete(m.starts, detail::analyse_drift(m.starts, m.samples));
+            }
+        }
+
+        inline void remember_plan(configuration const& cfg, std::string const& name, parameters const& params, int iterations, fp_seconds estimated, plan_cache& plans) {
+            // single iteration samples say nothing about the iterations needed otherwise
+            if(cfg.cache == cache_mode::cold_iteration) return;
+            plans.insert(name, params, { iterations, estimated / (static_cast<double>(iterations) * cfg.samples) });
+        }
+
+        // Prepares a benchmark, reusing and recording iteration estimates in the plan cache if any.
+        template <typename Clock>
+        execution_plan<FloatDuration<Clock>> prepare_benchmark(configuration const& cfg, environment<FloatDuration<Clock>> env, benchmark const& bench, parameters const& params, plan_cache* plans) {
+            if(plans) {
+                if(auto cached = plans->find(bench.name, params)) {
+                    return bench.template prepare<Clock>(cfg, params, cached->iterations, FloatDuration<Clock>(cached->iteration_time));
+                }
+            }
+            auto plan = bench.template prepare<Clock>(cfg, params, env);
+            if(plans) remember_plan(cfg, bench.name, params, plan.iterations_per_sample, fp_seconds(plan.estimated_duration), *plans);
+            return plan;
+        }
+        template <typename Duration>
+        std::vector<double> duration_counts(std::vector<Duration> const& durations) {
+            std::vector<double> counts;
+            counts.reserve(durations.size());
+            std::transform(durations.begin(), durations.end(), std::back_inserter(counts), [](Duration d) { return d.count(); });
+            return counts;
+        }
+        template <typename Duration>
+        std::vector<Duration> durations_from_counts(std::vector<double> const& counts) {
+            std::vector<Duration> durations;
+            durations.reserve(counts.size());
+            std::transform(counts.begin(), counts.end(), std::back_inserter(durations), [](double d) { return Duration(d); });
+            return durations;
+        }
+
+#ifdef NONIUS_HAS_FORK
+        // Prepares and measures a benchmark in a child process, sends the results to fd, and exits.
+        template <typename Clock>
+        void run_isolated_child(configuration const& cfg, environment<FloatDuration<Clock>> env, benchmark const& bench, parameters const& params, plan_cache* plans, int fd) {
+            pipe_writer out { fd };
+            try {
+                if(cfg.first_calls > 0) {
+                    auto first = bench.template first_calls<Clock>(cfg, params, env);
+                    out.put(isolated_record::first_calls);
+                    out.put(duration_counts(first));
+                }
+
+                auto plan = prepare_benchmark<Clock>(cfg, env, bench, params, plans);
+                out.put(isolated_record::plan);
+                out.put(plan.iterations_per_sample);
+                out.put(plan.estimated_duration.count());
+
+                auto m = measure_benchmark<Clock>(cfg, env, plan);
+                out.put(isolated_record::samples);
+                out.put(duration_counts(m.samples));
+                out.put(duration_counts(m.starts));
+                out.put(m.allocations);
+                out.put(m.usage);
+                out.put(m.frequency.source);
+                out.put(m.frequency.nominal);
+                out.put(m.frequency.frequencies);
+            } catch(std::exception const& e) {
+                out.put(isolated_record::failure);
+                out.put(std::string(e.what()));
+            } catch(...) {
+                out.put(isolated_record::failure);
+                out.put(std::string("unknown error"));
+            }
+            std::cout.flush();
+            ::_exit(0);
+        }
+
+        // Reports the results a child sent to fd; wait() reaps the child and returns its status.
+        // Returns false if the benchmark failed or crashed.
+        template <typename Clock, typename Wait>
+        bool report_isolated(configuration const& cfg, environment<FloatDuration<Clock>> env, benchmark const& bench, parameters const& params, reporter& rep, plan_cache* plans, int fd, Wait wait) {
+            using duration = FloatDuration<Clock>;
+
+            pipe_reader in { fd };
+            auto fail = [&](std::string message) {
+                rep.benchmark_failure(std::make_exception_ptr(isolated_benchmark_error(std::move(message))));
+                return false;
+            };
+
+            isolated_record record;
+            while(in.get(record)) {
+                std::vector<double> counts;
+                if(record == isolated_record::first_calls) {
+                    if(!in.get(counts)) break;
+                    auto first = durations_from_counts<duration>(counts);
+                    rep.first_calls_complete(std::vector<fp_seconds>(first.begin(), first.end()));
+                } else if(record == isolated_record::plan) {
+                    int iterations;
+                    double estimated;
+                    if(!in.get(iterations) || !in.get(estimated)) break;
+                    if(plans) remember_plan(cfg, bench.name, params, iterations, duration(estimated), *plans);
+                    rep.measurement_start(execution_plan<duration> { iterations, duration(estimated), params, {}, duration(cfg.max_warmup), steady_state_window });
+                } else if(record == isolated_record::samples) {
+                    benchmark_measurement<duration> m;
+                    std::vector<double> start_counts;
+                    if(!in.get(counts) || !in.get(start_counts) || !in.get(m.allocations) || !in.get(m.usage)
+                       || !in.get(m.frequency.source) || !in.get(m.frequency.nominal) || !in.get(m.frequency.frequencies)) break;
+                    wait();
+                    m.samples = durations_from_counts<duration>(counts);
+                    m.starts = durations_from_counts<fp_seconds>(start_counts);
+                    report_measurement(cfg, env, m, rep);
+                    return true;
+                } else if(record == isolated_record::failure) {
+                    std::string message;
+                    if(!in.get(message)) break;
+                    wait();
+                    return fail(message);
+                } else {
+                    break;
+                }
+            }
+            return fail(child_status_message(wait()));
+        }
+#endif // NONIUS_HAS_FORK
+
+        // Runs the preparation and measurement of a benchmark in a child process, and reports the
+        // results from the parent. Returns false if the benchmark failed or crashed.
+        template <typename Clock>
+        bool run_isolated(configuration const& cfg, environment<FloatDuration<Clock>> env, benchmark const& bench, parameters const& params, reporter& rep, plan_cache* plans = nullptr) {
+#ifdef NONIUS_HAS_FORK
+            int fds[2];
+            if(::pipe(fds) != 0) throw std::system_error(errno, std::generic_category(), "could not create pipe");
+
+            std::cout.flush();
+            std::cerr.flush();
+            auto pid = ::fork();
+            if(pid < 0) {
+                ::close(fds[0]);
+                ::close(fds[1]);
+                throw std::system_error(errno, std::generic_category(), "could not fork");
+            }
+
+            if(pid == 0) {
+                ::close(fds[0]);
+                run_isolated_child<Clock>(cfg, env, bench, params, plans, fds[1]);
+            }
+
+            ::close(fds[1]);
+            return report_isolated<Clock>(cfg, env, bench, params, rep, plans, fds[0], [&] {
+                ::close(fds[0]);
+                int status = 0;
+                while(::waitpid(pid, &status, 0) < 0 && errno == EINTR) {}
+                return status;
+            });
+#else
+            (void)cfg; (void)env; (void)bench; (void)params; (void)rep; (void)plans;
+            throw isolation_unsupported();
+#endif // NONIUS_HAS_FORK
+        }
+
+#ifdef NONIUS_HAS_FORK
+        // A child running a benchmark in parallel with others, writing its results to a temporary
+        // file to be read once it is done.
+        struct isolated_job {
+            pid_t pid = -1;
+            std::FILE* results = nullptr;
+            int status = 0;
+            bool done = false;
+        };
+
+        template <typename Clock>
+        isolated_job spawn_isolated(configuration const& cfg, environment<FloatDuration<Clock>> env, benchmark const& bench, parameters const& params, plan_cache* plans, int cpu) {
+            isolated_job job;
+            job.results = std::tmpfile();
+            if(!job.results) throw std::system_error(errno, std::generic_category(), "could not create a temporary file");
+
+            std::cout.flush();
+            std::cerr.flush();
+            job.pid = ::fork();
+            if(job.pid < 0) {
+                std::fclose(job.results);
+                throw std::system_error(errno, std::generic_category(), "could not fork");
+            }
+            if(job.pid == 0) {
+                if(cpu >= 0) pin_to_cpu(cpu);
+                run_isolated_child<Clock>(cfg, env, bench, params, plans, ::fileno(job.results));
+            }
+            return job;
+        }
+
+        template <typename Clock>
+        bool report_job(configuration const& cfg, environment<FloatDuration<Clock>> env, benchmark const& bench, parameters const& params, reporter& rep, plan_cache* plans, isolated_job const& job) {
+            // the child shares the file offset, which it left at the end
+            ::lseek(::fileno(job.results), 0, SEEK_SET);
+            auto status = job.status;
+            return report_isolated<Clock>(cfg, env, bench, params, rep, plans, ::fileno(job.results), [status] { return status; });
+        }
+
+        // Waits until at least one of the running jobs is done and takes them off the list. The
+        // parent sleeps in waitid() until some child exits, so that it does not compete with the jobs
+        // for the CPU; children that are not jobs are left to their owner.
+        inline std::vector<std::size_t> wait_for_jobs(std::vector<isolated_job>& jobs, std::vector<std::size_t>& running) {
+            std::vector<std::size_t> finished;
+            for(bool blocked = false;; blocked = true) {
+                if(blocked) {
+                    siginfo_t info;
+                    info.si_pid = 0;
+                    auto r = ::waitid(P_ALL, 0, &info, WEXITED | WNOWAIT);
+                    if(r < 0 && errno == EINTR) continue;
+                    auto ours = std::any_of(running.begin(), running.end(), [&](std::size_t i) { return jobs[i].pid == info.si_pid; });
+                    // some other child exited and stays unreaped, so waitid() would not block again
+                    if(r == 0 && !ours) std::this_thread::sleep_for(chrono::milliseconds(1));
+                }
+                for(auto it = running.begin(); it != running.end();) {
+                    auto&& job = jobs[*it];
+                    auto r = ::waitpid(job.pid, &job.status, WNOHANG);
+                    if(r == job.pid || (r < 0 && errno != EINTR)) {
+                        job.done = true;
+                        finished.push_back(*it);
+                        it = running.erase(it);
+                    } else {
+                        ++it;
+                    }
+                }
+                if(!finished.empty()) return finished;
+            }
+        }
+
+        // Only keeps the mean of the samples.
+        struct mean_reporter : reporter {
+            std::string description() override { return "mean of the samples"; }
+            void do_measurement_complete(std::vector<fp_seconds> const& samples) override {
+                if(!samples.empty()) mean = std::accumulate(samples.begin(), samples.end(), fp_seconds::zero()) / samples.size();
+            }
+
+            fp_seconds mean = fp_seconds::zero();
+        };
+#endif // NONIUS_HAS_FORK
+
+        // Runs each benchmark in a child process like run_isolated, but several at a time, each on
+        // a core of its own, and reports them in order as they are done. A few of them are then
+        // run again on their own to see whether their neighbours changed their timings.
+        template <typename Clock>
+        void run_parallel(configuration const& cfg, environment<FloatDuration<Clock>> env, std::vector<benchmark> const& benchmarks, parameters const& params, reporter& rep, plan_cache* plans = nullptr) {
+#ifdef NONIUS_HAS_FORK
+            auto cpus = job_cpus(cfg.jobs, cfg.jobs_per_l3);
+            auto slots = cpus.empty() ? cfg.jobs : static_cast<int>(cpus.size());
+            auto cpu_of = [&](int slot) { return cpus.empty() ? -1 : cpus[slot]; };
+            std::vector<int> free_slots;
+            for(int slot = slots; slot-- > 0;) free_slots.push_back(slot);
+
+            auto checked = interference_check_indices(benchmarks.size());
+            auto is_checked = [&](std::size_t i) { return std::find(checked.begin(), checked.end(), i) != checked.end(); };
+
+            std::vector<isolated_job> jobs(benchmarks.size());
+            std::vector<int> job_slots(benchmarks.size(), -1);
+            std::vector<bool> succeeded(benchmarks.size(), false);
+            std::vector<std::size_t> running;
+            std::size_t next = 0, reported = 0;
+            while(reported < benchmarks.size()) {
+                while(!free_slots.empty() && next < benchmarks.size()) {
+                    job_slots[next] = free_slots.back();
+                    free_slots.pop_back();
+                    jobs[next] = spawn_isolated<Clock>(cfg, env, benchmarks[next], params, plans, cpu_of(job_slots[next]));
+                    running.push_back(next++);
+                }
+                for(auto i : wait_for_jobs(jobs, running)) free_slots.push_back(job_slots[i]);
+
+                for(; reported < benchmarks.size() && jobs[reported].done; ++reported) {
+                    auto&& bench = benchmarks[reported];
+                    rep.benchmark_start(bench.name);
+                    succeeded[reported] = report_job<Clock>(cfg, env, bench, params, rep, plans, jobs[reported]);
+                    if(succeeded[reported]) rep.benchmark_complete();
+                    if(!succeeded[reported] || !is_checked(reported)) {
+                        std::fclose(jobs[reported].results);
+                        jobs[reported].results = nullptr;
+                    }
+                }
+            }
+
+            if(slots <= 1) checked.clear();
+            auto quiet = cfg;
+            quiet.no_analysis = true;
+            for(auto i : checked) {
+                if(!succeeded[i]) continue;
+                mean_reporter parallel, serial;
+                report_job<Clock>(quiet, env, benchmarks[i], params, parallel, nullptr, jobs[i]);
+                std::fclose(jobs[i].results);
+
+                auto job = spawn_isolated<Clock>(quiet, env, benchmarks[i], params, plans, cpu_of(0));
+                while(::waitpid(job.pid, &job.status, 0) < 0 && errno == EINTR) {}
+                auto ok = report_job<Clock>(quiet, env, benchmarks[i], params, serial, nullptr, job);
+                std::fclose(job.results);
+                if(ok) rep.interference_check_complete({ benchmarks[i].name, parallel.mean, serial.mean });
+            }
+#else
+            (void)cfg; (void)env; (void)benchmarks; (void)params; (void)rep; (void)plans;
+            throw isolation_unsupported();
+#endif // NONIUS_HAS_FORK
+        }
+
+        inline void accumulate(resource_usage& total, resource_usage const& delta) {
+            total.user_time += delta.user_time;
+            total.system_time += delta.system_time;
+            total.max_rss_growth += delta.max_rss_growth;
+            total.minor_faults += delta.minor_faults;
+            total.major_faults += delta.major_faults;
+            total.voluntary_context_switches += delta.voluntary_context_switches;
+            total.involuntary_context_switches += delta.involuntary_context_switches;
+        }
+        inline void accumulate(allocation_stats& total, allocation_stats const& delta) {
+            total.calls += delta.calls;
+            total.bytes += delta.bytes;
+            total.peak_bytes = std::max(total.peak_bytes, delta.peak_bytes);
+            total.iterations += delta.iterations;
+        }
+
+        template <typename Duration>
+        struct planned_benchmark {
+            std::vector<Duration> first_calls;
+            execution_plan<Duration> plan;
+            std::exception_ptr error; // thrown while preparing
+            bool skipped = false;
+        };
+
+        // Prepares all the benchmarks for one set of parameters, keeping any errors for later.
+        template <typename Clock>
+        std::vector<planned_benchmark<FloatDuration<Clock>>> prepare_all(configuration const& cfg, environment<FloatDuration<Clock>> env, std::vector<benchmark> const& benchmarks, parameters const& params, plan_cache* plans = nullptr) {
+            std::vector<planned_benchmark<FloatDuration<Clock>>> planned(benchmarks.size());
+            for(std::size_t i = 0; i < benchmarks.size(); ++i) {
+                try {
+                    if(cfg.first_calls > 0) planned[i].first_calls = benchmarks[i].template first_calls<Clock>(cfg, params, env);
+                    planned[i].plan = prepare_benchmark<Clock>(cfg, env, benchmarks[i], params, plans);
+                } catch(...) {
+                    planned[i].error = std::current_exception();
+                }
+            }
+            return planned;
+        }
+
+        // Benchmarks that settle quickly are done after a couple of windows; the warmup time is only the cap.
+        template <typename Duration>
+        double expected_warmup(execution_plan<Duration> const& plan, int samples) {
+            auto sample = fp_seconds(plan.estimated_duration).count() / samples;
+            return std::min(fp_seconds(plan.warmup_time).count(), 2 * plan.warmup_window * sample);
+        }
+
+        // Prepares every benchmark up front and lowers the number of samples (or the time limit in
+        // adaptive mode) so that the rest of the suite fits in the time budget, skipping the most
+        // expensive benchmarks if needed.
+        template <typename Clock>
+        std::vector<std::vector<planned_benchmark<FloatDuration<Clock>>>> plan_time_budget(configuration& cfg, environment<FloatDuration<Clock>> env, std::vector<benchmark> const& benchmarks, std::vector<parameters> const& all_params, fp_seconds spent, reporter& rep, plan_cache* plans = nullptr) {
+            auto start = Clock::now();
+            std::vector<std::vector<planned_benchmark<FloatDuration<Clock>>>> planned;
+            for(auto&& params : all_params) planned.push_back(prepare_all<Clock>(cfg, env, benchmarks, params, plans));
+            spent += Clock::now() - start;
+
+            // the bootstrap resamples both the mean and the standard deviation, in parallel
+            auto analysis_cost = cfg.no_analysis ? 0. : bootstrap_cost_per_sample * cfg.resamples * cfg.samples;
+            std::vector<double> costs, overheads;
+            for(auto&& round : planned) {
+                for(auto&& p : round) {
+                    costs.push_back(p.error ? 0. : fp_seconds(p.plan.estimated_duration).count() / cfg.samples);
+                    overheads.push_back(p.error ? 0. : expected_warmup(p.plan, cfg.samples) + analysis_cost);
+                }
+            }
+            auto available = (cfg.time_budget * (1 - budget_margin) - spent).count();
+
+            budget_allocation allocation;
+            if(cfg.target_rel_ci > 0) {
+                auto left = std::max(available - std::accumulate(overheads.begin(), overheads.end(), 0.), 0.);
+                cfg.max_time = std::min(cfg.max_time, costs.empty() ? cfg.max_time : left / costs.size());
+                allocation = { cfg.samples, std::vector<bool>(costs.size(), false) };
+            } else {
+                allocation = allocate_budget(costs, overheads, available, cfg.samples, min_budget_samples);
+                cfg.samples = std::max(allocation.samples, 1);
+            }
+
+            auto estimated = fp_seconds::zero();
+            int skipped = 0;
+            std::size_t k = 0;
+            for(auto&& round : planned) {
+                for(auto&& p : round) {
+                    p.skipped = allocation.skipped[k];
+                    if(!p.skipped && !p.error) {
+                        p.plan.estimated_duration = FloatDuration<Clock>(fp_seconds(costs[k] * cfg.samples));
+                        estimated += fp_seconds(costs[k] * cfg.samples + overheads[k]);
+                    }
+                    skipped += p.skipped;
+                    ++k;
+                }
+            }
+            rep.time_budget_planned({ cfg.time_budget, estimated, cfg.samples, skipped });
+            return planned;
+        }
+
+        template <typename Duration, typename Entry>
+        void report_interleaved(configuration const& cfg, environment<Duration> env, std::vector<benchmark> const& benchmarks, std::vector<planned_benchmark<Duration>> const& planned, std::vector<Entry> const& entries, reporter& rep) {
+            bool failed = false;
+            for(std::size_t i = 0; i < benchmarks.size(); ++i) {
+                auto&& p = planned[i];
+                auto&& e = entries[i];
+                rep.benchmark_start(benchmarks[i].name);
+                if(p.skipped) {
+                    rep.benchmark_skipped();
+                    continue;
+                }
+                if(cfg.first_calls > 0) rep.first_calls_complete(std::vector<fp_seconds>(p.first_calls.begin(), p.first_calls.end()));
+                rep.measurement_start(p.plan);
+                if(e.error) {
+                    rep.benchmark_failure(e.error);
+                    failed = true;
+                    continue;
+                }
+                report_measurement(cfg, env, e.m, rep);
+                rep.benchmark_complete();
+            }
+            if(failed) throw benchmark_user_error();
+        }
+
+        // Takes the samples of all the benchmarks in rounds, each visiting the benchmarks in a new
+        // random order, so that drift over time affects all of them alike. Results are reported
+        // afterwards, one benchmark after the other as usual.
+        template <typename Clock>
+        void run_interleaved(configuration const& cfg, environment<FloatDuration<Clock>> env, std::vector<benchmark> const& benchmarks, std::vector<planned_benchmark<FloatDuration<Clock>>> const& planned, reporter& rep) {
+            using duration = FloatDuration<Clock>;
+            struct entry {
+                benchmark_measurement<duration> m;
+                std::unique_ptr<frequency_meter<Clock>> frequency;
+                std::exception_ptr error;
+            };
+            std::vector<entry> entries(benchmarks.size());
+
+            for(std::size_t i = 0; i < benchmarks.size(); ++i) {
+                if(planned[i].error) {
+                    rep.benchmark_start(benchmarks[i].name);
+                    rep.benchmark_failure(planned[i].error);
+                    throw benchmark_user_error();
+                }
+                entries[i].m.samples.reserve(cfg.samples);
+                if(cfg.frequency) entries[i].frequency.reset(new frequency_meter<Clock>());
+            }
+
+            std::vector<std::size_t> order;
+            for(std::size_t i = 0; i < benchmarks.size(); ++i) {
+                if(!planned[i].skipped) order.push_back(i);
+            }
+            if(order.empty()) return report_interleaved(cfg, env, benchmarks, planned, entries, rep);
+            for(auto i : order) {
+                try {
+                    planned[i].plan.template warmup<Clock>();
+                } catch(...) {
+                    entries[i].error = std::current_exception();
+                }
+            }
+
+            std::mt19937 rng { std::random_device{}() };
+            auto origin = Clock::now();
+            for(int round = 0; round < cfg.samples; ++round) {
+                std::shuffle(order.begin(), order.end(), rng);
+                for(auto i : order) {
+                    auto&& e = entries[i];
+                    auto&& plan = planned[i].plan;
+                    if(e.error) continue;
+                    try {
+                        reset_allocation_counters();
+                        auto usage_before = current_resource_usage();
+                        e.m.starts.push_back(Clock::now() - origin);
+                        e.m.samples.push_back(plan.template sample<Clock>(cfg, env, e.frequency.get()));
+                        auto usage_after = current_resource_usage();
+                        accumulate(e.m.usage, resource_usage_delta(usage_before, usage_after));
+                        accumulate(e.m.allocations, allocation_snapshot(static_cast<std::uint64_t>(plan.iterations_per_sample)));
+                    } catch(...) {
+                        e.error = std::current_exception();
+                    }
+                }
+            }
+
+            for(auto&& e : entries) {
+                if(e.frequency) e.m.frequency = e.frequency->readings();
+            }
+            report_interleaved(cfg, env, benchmarks, planned, entries, rep);
+        }
+        template <typename Clock>
+        void run_interleaved(configuration const& cfg, environment<FloatDuration<Clock>> env, std::vector<benchmark> const& benchmarks, parameters const& params, reporter& rep, plan_cache* plans = nullptr) {
+            run_interleaved<Clock>(cfg, env, benchmarks, prepare_all<Clock>(cfg, env, benchmarks, params, plans), rep);
+        }
+
+        // The benchmarks of one round that were assigned to the given shard.
+        inline std::vector<benchmark> shard_benchmarks(std::vector<benchmark> const& benchmarks, std::vector<int> const& shards, std::size_t round, int shard) {
+            if(shards.empty()) return benchmarks;
+            std::vector<benchmark> r;
+            for(std::size_t i = 0; i < benchmarks.size(); ++i) {
+                if(shards[round * benchmarks.size() + i] == shard) r.push_back(benchmarks[i]);
+            }
+            return r;
+        }
+    } // namespace detail
+
     inline std::vector<parameters> generate_params(param_configuration cfg) {
         auto params = global_param_registry().defaults().merged(cfg.map);
         if (!cfg.run) {
@@ -109,35 +690,113 @@ namespace nonius {
         return r;
     }
 
+    struct incompatible_configuration : virtual std::exception {
+        explicit incompatible_configuration(std::string message) : message(std::move(message)) {}
+
+        char const* what() const NONIUS_NOEXCEPT override {
+            return message.c_str();
+        }
+
+        std::string message;
+    };
+
     template <typename Clock = default_clock, typename Iterator>
     void go(configuration cfg, Iterator first, Iterator last, reporter& rep) {
+        // the budget is planned in this process over the whole suite, not per process or per shard
+        auto budget = cfg.time_budget > fp_seconds::zero();
+        if(cfg.isolate && cfg.interleave) throw incompatible_configuration("isolated benchmarks cannot be interleaved");
+        if(cfg.isolate && budget) throw incompatible_configuration("a time budget cannot be combined with isolation");
+        if(cfg.jobs > 1 && cfg.interleave) throw incompatible_configuration("parallel jobs cannot be interleaved");
+        if(cfg.jobs > 1 && budget) throw incompatible_configuration("a time budget cannot be combined with parallel jobs");
+        if(cfg.shard.count > 1 && budget) throw incompatible_configuration("a time budget cannot be combined with sharding");
+        // rounds take one sample of every benchmark, so they cannot stop per benchmark
+        if(cfg.interleave && cfg.target_rel_ci > 0) throw incompatible_configuration("adaptive sampling cannot be combined with interleaving");
+
+        auto suite_start = Clock::now();
         rep.configure(cfg);
 
-        auto env = detail::measure_environment<Clock>(rep);
+        auto env = detail::measure_environment<Clock>(cfg, rep);
         rep.suite_start();
 
         auto benchmarks = filter_benchmarks(first, last, cfg.filter_pattern);
         auto all_params = generate_params(cfg.params);
 
-        for (auto&& params : all_params) {
+        std::unique_ptr<detail::plan_cache> plans;
+        if(!cfg.plan_cache.empty()) {
+            plans.reset(new detail::plan_cache(detail::binary_identity(), cfg.pin_plans));
+            std::ifstream in(cfg.plan_cache);
+            if(in) plans->load(in);
+        }
+
+        std::vector<int> shards;
+        if(cfg.shard.count > 1) {
+            std::vector<std::string> names;
+            for(auto&& b : benchmarks) names.push_back(b.name);
+            auto plan = detail::plan_shards(cfg, names, all_params, plans.get());
+            rep.shard_planned(plan);
+            shards = std::move(plan.assignment);
+        }
+
+        std::vector<std::vector<detail::planned_benchmark<FloatDuration<Clock>>>> planned;
+        if(cfg.time_budget > fp_seconds::zero()) {
+            planned = detail::plan_time_budget<Clock>(cfg, env, benchmarks, all_params, Clock::now() - suite_start, rep, plans.get());
+        }
+
+        for (std::size_t round = 0; round < all_params.size(); ++round) {
+            auto&& params = all_params[round];
             rep.params_start(params);
-            for (auto&& bench : benchmarks) {
+            if(cfg.jobs > 1) {
+                detail::run_parallel<Clock>(cfg, env, detail::shard_benchmarks(benchmarks, shards, round, cfg.shard.index), params, rep, plans.get());
+                rep.params_complete();
+                continue;
+            }
+            if(cfg.interleave) {
+                if(planned.empty()) detail::run_interleaved<Clock>(cfg, env, detail::shard_benchmarks(benchmarks, shards, round, cfg.shard.index), params, rep, plans.get());
+                else detail::run_interleaved<Clock>(cfg, env, benchmarks, planned[round], rep);
+                rep.params_complete();
+                continue;
+            }
+            for (std::size_t i = 0; i < benchmarks.size(); ++i) {
+                if(!shards.empty() && shards[round * benchmarks.size() + i] != cfg.shard.index) continue;
+                auto&& bench = benchmarks[i];
                 rep.benchmark_start(bench.name);
 
-                auto plan = user_code(rep, [&]{
-                    return bench.template prepare<Clock>(cfg, params, env);
-                });
+                if(cfg.isolate) {
+                    if(!detail::run_isolated<Clock>(cfg, env, bench, params, rep, plans.get())) continue;
+                } else if(!planned.empty()) {
+                    auto&& p = planned[round][i];
+                    if(p.skipped) {
+                        rep.benchmark_skipped();
+                        continue;
+                    }
+                    if(p.error) {
+                        rep.benchmark_failure(p.error);
+                        throw benchmark_user_error();
+                    }
+                    if(cfg.first_calls > 0) rep.first_calls_complete(std::vector<fp_seconds>(p.first_calls.begin(), p.first_calls.end()));
 
-                rep.measurement_start(plan);
-                auto samples = user_code(rep, [&]{
-                    return plan.template run<Clock>(cfg, env);
-                });
-                rep.measurement_complete(std::vector<fp_seconds>(samples.begin(), samples.end()));
+                    rep.measurement_start(p.plan);
+                    auto m = user_code(rep, [&]{
+                        return detail::measure_benchmark<Clock>(cfg, env, p.plan);
+                    });
+                    detail::report_measurement(cfg, env, m, rep);
+                } else {
+                    if(cfg.first_calls > 0) {
+                        auto first = user_code(rep, [&]{
+                            return bench.template first_calls<Clock>(cfg, params, env);
+                        });
+                        rep.first_calls_complete(std::vector<fp_seconds>(first.begin(), first.end()));
+                    }
 
-                if(!cfg.no_analysis) {
-                    rep.analysis_start();
-                    auto analysis = detail::analyse(cfg, env, samples.begin(), samples.end());
-                    rep.analysis_complete(analysis);
+                    auto plan = user_code(rep, [&]{
+                        return detail::prepare_benchmark<Clock>(cfg, env, bench, params, plans.get());
+                    });
+
+                    rep.measurement_start(plan);
+                    auto m = user_code(rep, [&]{
+                        return detail::measure_benchmark<Clock>(cfg, env, plan);
+                    });
+                    detail::report_measurement(cfg, env, m, rep);
                 }
 
                 rep.benchmark_complete();
@@ -145,6 +804,10 @@ namespace nonius {
             rep.params_complete();
         }
 
+        if(plans) {
+            std::ofstream out(cfg.plan_cache);
+            plans->save(out);
+        }
         rep.suite_complete();
     }
     struct duplicate_benchmarks : virtual std::exception {
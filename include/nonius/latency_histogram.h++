@@ -0,0 +1,92 @@
+// Nonius - C++ benchmarking tool
+//
+// Written in 2014- by the nonius contributors <nonius@rmf.io>
+//
+// To the extent possible under law, the author(s) have dedicated all copyright and related
+// and neighboring rights to this software to the public domain worldwide. This software is
+// distributed without any warranty.
+//
+// You should have received a copy of the CC0 Public Domain Dedication along with this software.
+// If not, see <http://creativecommons.org/publicdomain/zero/1.0/>
+
+// Latency histogram
+
+#ifndef NONIUS_LATENCY_HISTOGRAM_HPP
+#define NONIUS_LATENCY_HISTOGRAM_HPP
+
+#include <nonius/clock.h++>
+
+#include <algorithm>
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+
+namespace nonius {
+    // Counts of latencies in nanoseconds, in buckets that double in width with every power of two
+    // like HdrHistogram, so that any value is kept to within 1% of it with a fixed amount of memory.
+    struct latency_histogram {
+        static const int sub_bucket_bits = 8;
+        static const std::uint64_t sub_buckets = std::uint64_t(1) << sub_bucket_bits;
+        static const std::uint64_t half_sub_buckets = sub_buckets / 2;
+
+        latency_histogram() : counts(sub_buckets + (64 - sub_bucket_bits) * half_sub_buckets) {}
+
+        void record(fp_seconds latency) {
+            record(static_cast<std::uint64_t>(std::max(latency.count(), 0.) * 1e9));
+        }
+        void record(std::uint64_t nanoseconds) {
+            ++counts[index(nanoseconds)];
+            ++n;
+            sum += static_cast<double>(nanoseconds);
+            highest = std::max(highest, nanoseconds);
+        }
+
+        void merge(latency_histogram const& other) {
+            for(std::size_t i = 0; i < counts.size(); ++i) counts[i] += other.counts[i];
+            n += other.n;
+            sum += other.sum;
+            highest = std::max(highest, other.highest);
+        }
+
+        std::uint64_t count() const { return n; }
+        fp_seconds mean() const { return fp_seconds(n > 0 ? sum / n * 1e-9 : 0.); }
+        fp_seconds max() const { return fp_seconds(highest * 1e-9); }
+
+        // Smallest latency that at least the given fraction of the recorded ones do not exceed,
+        // rounded up to the end of its bucket.
+        fp_seconds percentile(double fraction) const {
+            if(n == 0) return fp_seconds::zero();
+            auto rank = static_cast<std::uint64_t>(std::ceil(std::min(std::max(fraction, 0.), 1.) * n));
+            rank = std::max<std::uint64_t>(rank, 1);
+            std::uint64_t seen = 0;
+            for(std::size_t i = 0; i < counts.size(); ++i) {
+                seen += counts[i];
+                if(seen >= rank) return fp_seconds(std::min(highest_in(i), highest) * 1e-9);
+            }
+            return max();
+        }
+
+        static std::size_t index(std::uint64_t value) {
+            if(value < sub_buckets) return static_cast<std::size_t>(value);
+            int shift = 0;
+            while((value >> shift) >= sub_buckets) ++shift;
+            auto top = value >> shift; // in [half_sub_buckets, sub_buckets)
+            return static_cast<std::size_t>(sub_buckets + (shift - 1) * half_sub_buckets + (top - half_sub_buckets));
+        }
+        static std::uint64_t highest_in(std::size_t index) {
+            if(index < sub_buckets) return index;
+            auto shift = (index - sub_buckets) / half_sub_buckets + 1;
+            auto top = (index - sub_buckets) % half_sub_buckets + half_sub_buckets;
+            return ((top + 1) << shift) - 1;
+        }
+
+    private:
+        std::vector<std::uint64_t> counts;
+        std::uint64_t n = 0;
+        double sum = 0.;
+        std::uint64_t highest = 0;
+    };
+} // namespace nonius
+
+#endif // NONIUS_LATENCY_HISTOGRAM_HPP
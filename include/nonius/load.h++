@@ -0,0 +1,121 @@
+// Nonius - C++ benchmarking tool
+//
+// Written in 2014- by the nonius contributors <nonius@rmf.io>
+//
+// To the extent possible under law, the author(s) have dedicated all copyright and related
+// and neighboring rights to this software to the public domain worldwide. This software is
+// distributed without any warranty.
+//
+// You should have received a copy of the CC0 Public Domain Dedication along with this software.
+// If not, see <http://creativecommons.org/publicdomain/zero/1.0/>
+
+// Open-loop load generation
+
+#ifndef NONIUS_LOAD_HPP
+#define NONIUS_LOAD_HPP
+
+#include <nonius/clock.h++>
+#include <nonius/latency_histogram.h++>
+
+#include <algorithm>
+#include <exception>
+#include <random>
+#include <thread>
+#include <vector>
+#include <cstddef>
+
+namespace nonius {
+    enum class arrival_process { constant, poisson };
+
+    struct load_configuration {
+        double rate = 1000.; // operations per second, across all threads
+        arrival_process arrivals = arrival_process::constant;
+        fp_seconds duration = fp_seconds(1);
+        int threads = 1;
+    };
+
+    struct load_result {
+        double target_rate;
+        double achieved_rate;
+        latency_histogram latencies; // from the scheduled start of each operation
+    };
+
+    namespace detail {
+        const double load_saturation_tolerance = 0.05; // fraction of the target rate that may be missed
+        const double knee_latency_factor = 10.;        // p99 growth over the lightest load
+
+        template <typename Clock, typename Fun>
+        void generate_load(load_configuration const& cfg, int thread, TimePoint<Clock> start, Fun& op, latency_histogram& latencies) {
+            auto rate = cfg.rate / cfg.threads;
+            std::mt19937_64 rng { std::random_device{}() + static_cast<unsigned>(thread) };
+            std::exponential_distribution<double> gap(rate);
+            // threads are staggered so that constant arrivals are evenly spread
+            auto offset = fp_seconds(thread / cfg.rate);
+            auto end = start + chrono::duration_cast<Duration<Clock>>(cfg.duration);
+            for(std::uint64_t i = 0;; ++i) {
+                offset += fp_seconds(cfg.arrivals == arrival_process::poisson ? gap(rng) : (i == 0 ? 0. : 1. / rate));
+                auto scheduled = start + chrono::duration_cast<Duration<Clock>>(offset);
+                if(scheduled >= end) break;
+                while(Clock::now() < scheduled) std::this_thread::yield();
+                op();
+                latencies.record(chrono::duration_cast<fp_seconds>(Clock::now() - scheduled));
+            }
+        }
+    } // namespace detail
+
+    // Issues operations on a fixed schedule regardless of how long earlier ones took, and times
+    // each from when it was due rather than from when it was actually sent, so that stalls show up
+    // in the latencies of every operation they delayed (avoiding coordinated omission).
+    template <typename Clock = default_clock, typename Fun>
+    load_result run_load(load_configuration const& cfg, Fun&& op) {
+        auto threads = std::max(cfg.threads, 1);
+        std::vector<latency_histogram> latencies(threads);
+        std::vector<std::exception_ptr> errors(threads);
+        auto start = Clock::now();
+        auto work = [&](int t) {
+            try {
+                detail::generate_load<Clock>(cfg, t, start, op, latencies[t]);
+            } catch(...) {
+                errors[t] = std::current_exception();
+            }
+        };
+        std::vector<std::thread> workers;
+        for(int t = 1; t < threads; ++t) workers.emplace_back(work, t);
+        work(0);
+        for(auto&& w : workers) w.join();
+        auto elapsed = chrono::duration_cast<fp_seconds>(Clock::now() - start);
+        for(auto&& e : errors) {
+            if(e) std::rethrow_exception(e);
+        }
+
+        load_result result { cfg.rate, 0., {} };
+        for(auto&& l : latencies) result.latencies.merge(l);
+        result.achieved_rate = result.latencies.count() / std::max(elapsed, cfg.duration).count();
+        return result;
+    }
+
+    template <typename Clock = default_clock, typename Fun>
+    std::vector<load_result> sweep_load(load_configuration cfg, std::vector<double> const& rates, Fun&& op) {
+        std::vector<load_result> results;
+        for(auto rate : rates) {
+            cfg.rate = rate;
+            results.push_back(run_load<Clock>(cfg, op));
+        }
+        return results;
+    }
+
+    // Index of the highest rate that was sustained without the 99th percentile latency growing
+    // far beyond that of the lightest load, or -1 if even the first one was not.
+    inline int find_knee(std::vector<load_result> const& sweep) {
+        int knee = -1;
+        for(std::size_t i = 0; i < sweep.size(); ++i) {
+            auto&& r = sweep[i];
+            if(r.achieved_rate < r.target_rate * (1 - detail::load_saturation_tolerance)) break;
+            if(i > 0 && r.latencies.percentile(0.99) > sweep.front().latencies.percentile(0.99) * detail::knee_latency_factor) break;
+            knee = static_cast<int>(i);
+        }
+        return knee;
+    }
+} // namespace nonius
+
+#endif // NONIUS_LOAD_HPP
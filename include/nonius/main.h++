@@ -27,6 +27,7 @@
 #include <exception>
 #include <iostream>
 #include <iomanip>
+#include <sstream>
 #include <algorithm>
 #include <utility>
 #include <cstddef>
@@ -48,10 +49,45 @@ namespace nonius {
             static std::string parse(std::string const& s) { return s; }
         };
         template <>
+        struct parser<std::vector<std::string>> {
+            static std::vector<std::string> parse(std::string const& s) { return { s }; }
+        };
+        template <>
         struct parser<bool> {
             static bool parse(std::string const&) { return true; }
         };
         template <>
+        struct parser<fp_seconds> {
+            static fp_seconds parse(std::string const& s) {
+                std::size_t end;
+                auto value = std::stod(s, &end);
+                auto unit = s.substr(end);
+                if(unit.empty() || unit == "s") return fp_seconds(value);
+                else if(unit == "m") return fp_seconds(value * 60);
+                else if(unit == "h") return fp_seconds(value * 3600);
+                else throw argument_error();
+            }
+        };
+        template <>
+        struct parser<cache_mode> {
+            static cache_mode parse(std::string const& s) {
+                if(s == "warm") return cache_mode::warm;
+                else if(s == "sample") return cache_mode::cold_sample;
+                else if(s == "iteration") return cache_mode::cold_iteration;
+                throw argument_error();
+            }
+        };
+        template <>
+        struct parser<shard_configuration> {
+            static shard_configuration parse(std::string const& s) {
+                shard_configuration shard;
+                char slash;
+                std::istringstream ss(s);
+                if(!(ss >> shard.index >> slash >> shard.count) || slash != '/' || !ss.eof()) throw argument_error();
+                return shard;
+            }
+        };
+        template <>
         struct parser<param_configuration> {
             static param_configuration parse(std::string const& param) {
                 auto v = std::vector<std::string>{};
@@ -103,6 +139,11 @@ namespace nonius {
             static detail::option_set the_options {
                 detail::option("help", "h", "show this help message"),
                 detail::option("samples", "s", "number of samples to collect (default: 100)", "SAMPLES"),
+                detail::option("target-rel-ci", "tci", "take samples until the confidence interval of the mean is within this fraction of it (default: 0, fixed number of samples)", "WIDTH"),
+                detail::option("max-time", "mt", "maximum time in seconds to spend sampling a benchmark when using --target-rel-ci (default: 10)", "SECONDS"),
+                detail::option("max-warmup", "mw", "maximum time to spend warming up each benchmark before its timings settle, with an optional unit of s, m or h (default: 1s)", "TIME"),
+                detail::option("time-budget", "tb", "fit the whole run in this much time, with an optional unit of s, m or h (e.g. 10m), lowering samples and skipping benchmarks as needed", "TIME"),
+                detail::option("first-calls", "fc", "number of initial runs to time individually, before estimation (default: 0)", "CALLS"),
                 detail::option("resamples", "rs", "number of resamples for the bootstrap (default: 100000)", "RESAMPLES"),
                 detail::option("confidence-interval", "ci", "confidence interval for the bootstrap (between 0 and 1, default: 0.95)", "INTERVAL"),
                 detail::option("param", "p", "set a benchmark parameter", "PARAM"),
@@ -110,6 +151,18 @@ namespace nonius {
                 detail::option("reporter", "r", "reporter to use (default: standard)", "REPORTER"),
                 detail::option("title", "t", "set report title", "TITLE"),
                 detail::option("no-analysis", "A", "perform only measurements; do not perform any analysis"),
+                detail::option("plan-cache", "pc", "reuse the iteration counts stored in this file by previous runs of the same executable, and store new ones", "FILE"),
+                detail::option("pin-plans", "pp", "reuse the iteration counts in the plan cache even if the executable changed"),
+                detail::option("env-cache", "ec", "reuse the clock resolution and cost measured on this host within the expiry time, stored in this file", "FILE"),
+                detail::option("env-cache-expiry", "ece", "how long a cached environment is used, with an optional unit of s, m or h (default: 1h)", "TIME"),
+                detail::option("isolate", "i", "run each benchmark in a separate process"),
+                detail::option("interleave", "il", "take samples of all benchmarks in random round-robin order (mutually exclusive with -i and -tci)"),
+                detail::option("jobs", "j", "run this many benchmarks at once, each in its own process on its own physical core (default: 1)", "JOBS"),
+                detail::option("jobs-per-l3", "jl", "with --jobs, run at most one benchmark on each L3 cache domain"),
+                detail::option("shard", "sh", "run only shard I of N, balancing the shards by the estimates in the plan cache (e.g. 2/4)", "I/N"),
+                detail::option("merge", "m", "instead of running benchmarks, analyse and report the results stored by the raw reporter in this file (may be repeated)", "FILE"),
+                detail::option("cold-cache", "cc", "evict data caches before each sample or each iteration (MODE is one of warm, sample, iteration; default: warm); with iteration, runs much shorter than the clock resolution cannot be timed precisely", "MODE"),
+                detail::option("frequency", "fq", "measure the effective CPU frequency during each sample and report cycles and frequency-normalized times"),
                 detail::option("filter", "f", "only run benchmarks whose name matches the regular expression pattern", "PATTERN"),
                 detail::option("list", "l", "list benchmarks"),
                 detail::option("list-params", "lp", "list available parameters"),
@@ -140,12 +193,31 @@ namespace nonius {
 
                 parse(cfg.help, args, "help");
                 parse(cfg.samples, args, "samples", is_positive);
+                parse(cfg.target_rel_ci, args, "target-rel-ci", [](double x) { return x >= 0; });
+                parse(cfg.max_time, args, "max-time", [](double x) { return x > 0; });
+                parse(cfg.max_warmup, args, "max-warmup", [](fp_seconds x) { return x >= fp_seconds::zero(); });
+                parse(cfg.time_budget, args, "time-budget", [](fp_seconds x) { return x > fp_seconds::zero(); });
+                parse(cfg.first_calls, args, "first-calls", [](int x) { return x >= 0; });
                 parse(cfg.resamples, args, "resamples", is_positive);
                 parse(cfg.confidence_interval, args, "confidence-interval", is_ci);
                 parse(cfg.params, args, "param", is_param, merge_params);
                 parse(cfg.output_file, args, "output");
                 parse(cfg.reporter, args, "reporter", is_reporter);
                 parse(cfg.no_analysis, args, "no-analysis");
+                parse(cfg.plan_cache, args, "plan-cache");
+                parse(cfg.pin_plans, args, "pin-plans");
+                parse(cfg.env_cache, args, "env-cache");
+                parse(cfg.env_cache_expiry, args, "env-cache-expiry", [](fp_seconds x) { return x > fp_seconds::zero(); });
+                parse(cfg.isolate, args, "isolate");
+                parse(cfg.interleave, args, "interleave");
+                parse(cfg.jobs, args, "jobs", is_positive);
+                parse(cfg.jobs_per_l3, args, "jobs-per-l3");
+                parse(cfg.shard, args, "shard", [](shard_configuration const& x) { return x.count > 0 && x.index > 0 && x.index <= x.count; });
+                parse(cfg.merge_files, args, "merge", [](std::vector<std::string> const&) { return true; }, [](std::vector<std::string>& x, std::vector<std::string>&& y) {
+                    x.insert(x.end(), y.begin(), y.end());
+                });
+                parse(cfg.cache, args, "cold-cache");
+                parse(cfg.frequency, args, "frequency");
                 parse(cfg.filter_pattern, args, "filter");
                 parse(cfg.list_benchmarks, args, "list");
                 parse(cfg.list_params, args, "list-params");
@@ -154,6 +226,11 @@ namespace nonius {
                 parse(cfg.summary, args, "summary");
                 parse(cfg.title, args, "title");
                 if(cfg.verbose && cfg.summary) throw argument_error();
+                if(cfg.isolate && cfg.interleave) throw argument_error();
+                if(cfg.interleave && cfg.target_rel_ci > 0) throw argument_error();
+                if(cfg.isolate && cfg.time_budget > fp_seconds::zero()) throw argument_error();
+                if(cfg.jobs > 1 && (cfg.interleave || cfg.time_budget > fp_seconds::zero())) throw argument_error();
+                if(cfg.shard.count > 1 && cfg.time_budget > fp_seconds::zero()) throw argument_error();
 
                 return cfg;
             } catch(...) {
@@ -210,6 +287,16 @@ namespace nonius {
         return 0;
     }
 
+    inline int merge_it(configuration cfg) {
+        try {
+            nonius::merge(cfg);
+        } catch(std::exception const& e) {
+            std::cerr << "could not merge results: " << e.what() << "\n";
+            return 29;
+        }
+        return 0;
+    }
+
     template <typename Iterator>
     int main(std::string const& name, Iterator first, Iterator last) {
         configuration cfg;
@@ -224,6 +311,7 @@ namespace nonius {
         else if(cfg.list_benchmarks) return list_benchmarks();
         else if(cfg.list_params) return list_params();
         else if(cfg.list_reporters) return list_reporters();
+        else if(!cfg.merge_files.empty()) return merge_it(cfg);
         else return run_it(cfg);
     }
     inline int main(int argc, char** argv) {
@@ -0,0 +1,292 @@
+// Nonius - C++ benchmarking tool
+//
+// Written in 2014- by the nonius contributors <nonius@rmf.io>
+//
+// To the extent possible under law, the author(s) have dedicated all copyright and related
+// and neighboring rights to this software to the public domain worldwide. This software is
+// distributed without any warranty.
+//
+// You should have received a copy of the CC0 Public Domain Dedication along with this software.
+// If not, see <http://creativecommons.org/publicdomain/zero/1.0/>
+
+// Merging raw results
+
+#ifndef NONIUS_MERGE_HPP
+#define NONIUS_MERGE_HPP
+
+#include <nonius/clock.h++>
+#include <nonius/configuration.h++>
+#include <nonius/environment.h++>
+#include <nonius/execution_plan.h++>
+#include <nonius/reporter.h++>
+#include <nonius/resource_usage.h++>
+#include <nonius/go.h++>
+#include <nonius/detail/allocation_counters.h++>
+#include <nonius/detail/analyse.h++>
+#include <nonius/detail/drift.h++>
+#include <nonius/detail/frequency.h++>
+#include <nonius/detail/noexcept.h++>
+#include <nonius/detail/plan_cache.h++>
+#include <nonius/detail/steady_state.h++>
+
+#include <algorithm>
+#include <exception>
+#include <fstream>
+#include <istream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include <cstddef>
+
+namespace nonius {
+    struct raw_result_error : virtual std::exception {
+        explicit raw_result_error(std::string message) : message(std::move(message)) {}
+
+        char const* what() const NONIUS_NOEXCEPT override {
+            return message.c_str();
+        }
+
+        std::string message;
+    };
+
+    // A failure recorded in a raw result file, or a benchmark missing from all of them.
+    struct merged_benchmark_error : virtual std::exception {
+        explicit merged_benchmark_error(std::string message) : message(std::move(message)) {}
+
+        char const* what() const NONIUS_NOEXCEPT override {
+            return message.c_str();
+        }
+
+        std::string message;
+    };
+
+    namespace detail {
+        struct raw_benchmark {
+            std::string name;
+            std::vector<fp_seconds> first_calls;
+            bool planned = false;
+            int iterations = 0;
+            fp_seconds estimated = fp_seconds::zero();
+            std::vector<fp_seconds> samples;
+            std::vector<fp_seconds> starts;
+            bool has_allocations = false;
+            allocation_stats allocations;
+            bool has_usage = false;
+            resource_usage usage;
+            bool has_frequency = false;
+            frequency_readings frequency;
+            bool failed = false;
+            std::string failure;
+        };
+
+        struct raw_results {
+            int samples = 0;
+            int resamples = 0;
+            double confidence_interval = 0.;
+            std::map<std::string, environment_estimate<fp_seconds>> environment;
+            std::vector<std::string> suite; // empty unless the files come from shards
+            int rounds = 0;
+            std::map<int, std::string> params;
+            std::map<std::pair<int, std::size_t>, raw_benchmark> benchmarks; // by round and position
+        };
+
+        inline std::vector<fp_seconds> parse_durations(std::vector<std::string> const& fields) {
+            std::vector<fp_seconds> durations;
+            for(std::size_t i = 1; i < fields.size(); ++i) durations.push_back(fp_seconds(std::stod(fields[i])));
+            return durations;
+        }
+
+        // Adds the contents of a file written by the raw reporter. Benchmarks already seen in
+        // another file are kept as they were.
+        inline void read_raw_results(std::istream& is, std::string const& file, raw_results& results) {
+            std::string line;
+            if(!std::getline(is, line) || split_fields(line) != std::vector<std::string> { "nonius-raw", "1" }) {
+                throw raw_result_error(file + " is not a raw result file");
+            }
+            std::map<std::pair<int, std::size_t>, raw_benchmark> read;
+            raw_benchmark* current = nullptr;
+            try {
+                while(std::getline(is, line)) {
+                    auto fields = split_fields(line);
+                    auto&& kind = fields[0];
+                    if(kind == "samples" && fields.size() == 2) {
+                        if(results.samples == 0) results.samples = std::stoi(fields[1]);
+                    } else if(kind == "resamples" && fields.size() == 2) {
+                        if(results.resamples == 0) results.resamples = std::stoi(fields[1]);
+                    } else if(kind == "confidence_interval" && fields.size() == 2) {
+                        if(results.confidence_interval == 0) results.confidence_interval = std::stod(fields[1]);
+                    } else if((kind == "clock_resolution" || kind == "clock_cost" || kind == "function_cost") && fields.size() == 7) {
+                        environment_estimate<fp_seconds> estimate;
+                        estimate.mean = fp_seconds(std::stod(fields[1]));
+                        estimate.outliers.samples_seen = std::stoi(fields[2]);
+                        estimate.outliers.low_severe = std::stoi(fields[3]);
+                        estimate.outliers.low_mild = std::stoi(fields[4]);
+                        estimate.outliers.high_mild = std::stoi(fields[5]);
+                        estimate.outliers.high_severe = std::stoi(fields[6]);
+                        results.environment.insert({ kind, estimate });
+                    } else if(kind == "shard" && fields.size() >= 4) {
+                        results.rounds = std::max(results.rounds, std::stoi(fields[3]));
+                        if(results.suite.empty()) results.suite.assign(fields.begin() + 4, fields.end());
+                    } else if(kind == "params" && fields.size() == 3) {
+                        auto round = std::stoi(fields[1]);
+                        results.rounds = std::max(results.rounds, round + 1);
+                        results.params.insert({ round, fields[2] });
+                    } else if(kind == "benchmark" && fields.size() == 4) {
+                        auto key = std::make_pair(std::stoi(fields[1]), static_cast<std::size_t>(std::stoul(fields[2])));
+                        current = &read[key];
+                        *current = raw_benchmark();
+                        current->name = fields[3];
+                    } else if(!current) {
+                        continue;
+                    } else if(kind == "first_calls") {
+                        current->first_calls = parse_durations(fields);
+                    } else if(kind == "plan" && fields.size() == 3) {
+                        current->planned = true;
+                        current->iterations = std::stoi(fields[1]);
+                        current->estimated = fp_seconds(std::stod(fields[2]));
+                    } else if(kind == "measurement") {
+                        current->samples = parse_durations(fields);
+                    } else if(kind == "starts") {
+                        current->starts = parse_durations(fields);
+                    } else if(kind == "allocations" && fields.size() == 5) {
+                        current->has_allocations = true;
+                        current->allocations.calls = std::stoull(fields[1]);
+                        current->allocations.bytes = std::stoull(fields[2]);
+                        current->allocations.peak_bytes = std::stoull(fields[3]);
+                        current->allocations.iterations = std::stoull(fields[4]);
+                    } else if(kind == "resource_usage" && fields.size() == 8) {
+                        current->has_usage = true;
+                        current->usage.user_time = fp_seconds(std::stod(fields[1]));
+                        current->usage.system_time = fp_seconds(std::stod(fields[2]));
+                        current->usage.max_rss_growth = std::stoll(fields[3]);
+                        current->usage.minor_faults = std::stoll(fields[4]);
+                        current->usage.major_faults = std::stoll(fields[5]);
+                        current->usage.voluntary_context_switches = std::stoll(fields[6]);
+                        current->usage.involuntary_context_switches = std::stoll(fields[7]);
+                    } else if(kind == "frequency" && fields.size() >= 3 && fields[1].size() == 1) {
+                        current->has_frequency = true;
+                        current->frequency.source = static_cast<frequency_source>(fields[1][0]);
+                        current->frequency.nominal = std::stod(fields[2]);
+                        current->frequency.frequencies.clear();
+                        for(std::size_t i = 3; i < fields.size(); ++i) current->frequency.frequencies.push_back(std::stod(fields[i]));
+                    } else if(kind == "failure" && fields.size() == 2) {
+                        current->failed = true;
+                        current->failure = fields[1];
+                    }
+                }
+            } catch(std::exception const&) {
+                throw raw_result_error(file + " is corrupt near: " + line);
+            }
+            for(auto&& b : read) {
+                // runs cut short leave the last benchmark unfinished
+                if(b.second.failed || !b.second.samples.empty()) results.benchmarks.insert(b);
+            }
+        }
+
+        // The parameters as written by params_key. Values of parameters declared in this program are
+        // read as their declared type; the others, as strings.
+        inline parameters parse_params_key(std::string const& key, parameters const& declared = global_param_registry().defaults()) {
+            parameters params;
+            std::size_t start = 0;
+            while(start < key.size()) {
+                auto end = key.find(';', start);
+                if(end == std::string::npos) end = key.size();
+                auto entry = key.substr(start, end - start);
+                auto equals = entry.find('=');
+                if(equals != std::string::npos) {
+                    auto name = entry.substr(0, equals);
+                    auto value = entry.substr(equals + 1);
+                    auto it = declared.find(name);
+                    if(it != declared.end()) {
+                        try {
+                            params.insert({ name, it->second.parse(value) });
+                        } catch(std::exception const&) {
+                            params.insert({ name, param(value) });
+                        }
+                    } else {
+                        params.insert({ name, param(value) });
+                    }
+                }
+                start = end + 1;
+            }
+            return params;
+        }
+
+        inline void report_raw_benchmark(configuration const& cfg, environment<fp_seconds> const& env, parameters const& params, raw_benchmark const& b, reporter& rep) {
+            rep.benchmark_start(b.name);
+            if(!b.first_calls.empty()) rep.first_calls_complete(b.first_calls);
+            if(b.planned) rep.measurement_start(execution_plan<fp_seconds> { b.iterations, b.estimated, params, {}, cfg.max_warmup, steady_state_window });
+            if(b.failed) {
+                rep.benchmark_failure(std::make_exception_ptr(merged_benchmark_error(b.failure)));
+                return;
+            }
+            rep.measurement_complete(b.samples);
+            if(b.starts.size() == b.samples.size()) rep.sample_starts_complete(b.starts);
+            if(b.has_usage) rep.resource_usage_complete(b.usage);
+            if(b.has_frequency) rep.frequency_complete(analyse_frequency(b.frequency, b.samples));
+            if(b.has_allocations) rep.allocations_complete(b.allocations);
+            if(!cfg.no_analysis) {
+                rep.analysis_start();
+                rep.analysis_complete(analyse(cfg, env, b.samples.begin(), b.samples.end()));
+                if(b.starts.size() == b.samples.size()) rep.drift_analysis_complete(b.starts, analyse_drift(b.starts, b.samples));
+            }
+            rep.benchmark_complete();
+        }
+    } // namespace detail
+
+    // Analyses and reports the results from the raw result files in cfg.merge_files as if they
+    // came from a single run. The environment, and the number of samples, resamples and confidence
+    // interval used in the analysis, are those of the first file that has them.
+    inline void merge(configuration cfg, reporter& rep) {
+        detail::raw_results results;
+        for(auto&& file : cfg.merge_files) {
+            std::ifstream in(file);
+            if(!in) throw raw_result_error("could not open " + file);
+            detail::read_raw_results(in, file, results);
+        }
+        if(results.samples > 0) cfg.samples = results.samples;
+        if(results.resamples > 0) cfg.resamples = results.resamples;
+        if(results.confidence_interval > 0) cfg.confidence_interval = results.confidence_interval;
+        rep.configure(cfg);
+
+        environment<fp_seconds> env;
+        env.clock_resolution = results.environment["clock_resolution"];
+        env.clock_cost = results.environment["clock_cost"];
+        env.function_cost = results.environment["function_cost"];
+        if(!results.environment.empty()) rep.environment_reused();
+        if(results.environment.count("clock_resolution")) rep.estimate_clock_resolution_complete(env.clock_resolution);
+        if(results.environment.count("clock_cost")) rep.estimate_clock_cost_complete(env.clock_cost);
+        if(results.environment.count("function_cost")) rep.estimate_function_cost_complete(env.function_cost);
+        rep.suite_start();
+
+        for(int round = 0; round < results.rounds; ++round) {
+            auto params = detail::parse_params_key(results.params[round]);
+            rep.params_start(params);
+            if(results.suite.empty()) {
+                for(auto it = results.benchmarks.lower_bound({ round, 0 }); it != results.benchmarks.end() && it->first.first == round; ++it) {
+                    detail::report_raw_benchmark(cfg, env, params, it->second, rep);
+                }
+            } else {
+                for(std::size_t i = 0; i < results.suite.size(); ++i) {
+                    auto it = results.benchmarks.find({ round, i });
+                    if(it != results.benchmarks.end()) {
+                        detail::report_raw_benchmark(cfg, env, params, it->second, rep);
+                    } else {
+                        rep.benchmark_start(results.suite[i]);
+                        rep.benchmark_failure(std::make_exception_ptr(merged_benchmark_error("no results in any of the merged files")));
+                    }
+                }
+            }
+            rep.params_complete();
+        }
+        rep.suite_complete();
+    }
+    inline void merge(configuration cfg, reporter_registry& reporters = global_reporter_registry()) {
+        auto it = reporters.find(cfg.reporter);
+        if(it == reporters.end()) throw no_such_reporter();
+        merge(cfg, *it->second);
+    }
+} // namespace nonius
+
+#endif // NONIUS_MERGE_HPP
@@ -19,8 +19,13 @@
 #include <nonius/constructor.h++>
 #include <nonius/configuration.h++>
 #include <nonius/chronometer.h++>
+#include <nonius/allocation.h++>
+#include <nonius/static_benchmark.h++>
 #include <nonius/optimizer.h++>
 #include <nonius/go.h++>
+#include <nonius/load.h++>
+#include <nonius/merge.h++>
+#include <nonius/binary_results.h++>
 #include <nonius/param.h++>
 
 #include <nonius/reporters/standard_reporter.h++>
@@ -32,6 +37,15 @@
 #ifndef NONIUS_DISABLE_JUNIT_REPORTER
 #include <nonius/reporters/junit_reporter.h++>
 #endif // NONIUS_DISABLE_JUNIT_REPORTER
+#ifndef NONIUS_DISABLE_JSON_REPORTER
+#include <nonius/reporters/json_reporter.h++>
+#endif // NONIUS_DISABLE_JSON_REPORTER
+#ifndef NONIUS_DISABLE_BINARY_REPORTER
+#include <nonius/reporters/binary_reporter.h++>
+#endif // NONIUS_DISABLE_BINARY_REPORTER
+#ifndef NONIUS_DISABLE_RAW_REPORTER
+#include <nonius/reporters/raw_reporter.h++>
+#endif // NONIUS_DISABLE_RAW_REPORTER
 #ifndef NONIUS_DISABLE_HTML_REPORTER
 #include <nonius/reporters/html_reporter.h++>
 #endif // NONIUS_DISABLE_HTML_REPORTER
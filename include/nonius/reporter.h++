@@ -19,6 +19,13 @@
 #include <nonius/environment.h++>
 #include <nonius/execution_plan.h++>
 #include <nonius/sample_analysis.h++>
+#include <nonius/drift_analysis.h++>
+#include <nonius/frequency_analysis.h++>
+#include <nonius/resource_usage.h++>
+#include <nonius/detail/time_budget.h++>
+#include <nonius/detail/parallel.h++>
+#include <nonius/detail/shard.h++>
+#include <nonius/detail/allocation_counters.h++>
 #include <nonius/detail/noexcept.h++>
 #include <nonius/detail/unique_name.h++>
 
@@ -38,6 +45,11 @@ namespace nonius {
             return "failed to open file";
         }
     };
+    struct binary_on_console : virtual std::exception {
+        char const* what() const NONIUS_NOEXCEPT override {
+            return "this reporter writes binary data and needs an output file";
+        }
+    };
 
     struct reporter {
     public:
@@ -45,9 +57,11 @@ namespace nonius {
 
         void configure(configuration& cfg) {
             if(cfg.output_file.empty()) {
+                if(binary_output()) throw binary_on_console();
                 os = [&]() -> std::ostream& { return std::cout; };
             } else {
-                auto ofs = std::make_shared<std::ofstream>(cfg.output_file);
+                auto mode = binary_output() ? std::ios::out | std::ios::binary : std::ios::out;
+                auto ofs = std::make_shared<std::ofstream>(cfg.output_file, mode);
                 os = [ofs]() -> std::ostream& { return *ofs; };
             }
             report_stream().exceptions(std::ios::failbit);
@@ -75,9 +89,25 @@ namespace nonius {
             do_estimate_clock_cost_complete(estimate);
         }
 
+        void estimate_function_cost_start() {
+            do_estimate_function_cost_start();
+        }
+        void estimate_function_cost_complete(environment_estimate<fp_seconds> estimate) {
+            do_estimate_function_cost_complete(estimate);
+        }
+        void environment_reused() {
+            do_environment_reused();
+        }
+
         void suite_start() {
             do_suite_start();
         }
+        void time_budget_planned(time_budget_plan const& plan) {
+            do_time_budget_planned(plan);
+        }
+        void shard_planned(shard_plan const& plan) {
+            do_shard_planned(plan);
+        }
         void params_start(parameters const& params) {
             do_params_start(params);
         }
@@ -85,12 +115,28 @@ namespace nonius {
             do_benchmark_start(name);
         }
 
+        void first_calls_complete(std::vector<fp_seconds> const& times) {
+            do_first_calls_complete(times);
+        }
+
         void measurement_start(execution_plan<fp_seconds> plan) {
             do_measurement_start(plan);
         }
         void measurement_complete(std::vector<fp_seconds> const& samples) {
             do_measurement_complete(samples);
         }
+        void sample_starts_complete(std::vector<fp_seconds> const& starts) {
+            do_sample_starts_complete(starts);
+        }
+        void allocations_complete(allocation_stats const& stats) {
+            do_allocations_complete(stats);
+        }
+        void resource_usage_complete(resource_usage const& usage) {
+            do_resource_usage_complete(usage);
+        }
+        void frequency_complete(frequency_analysis const& frequency) {
+            do_frequency_complete(frequency);
+        }
 
         void analysis_start() {
             do_analysis_start();
@@ -98,13 +144,22 @@ namespace nonius {
         void analysis_complete(sample_analysis<fp_seconds> const& analysis) {
             do_analysis_complete(analysis);
         }
+        void drift_analysis_complete(std::vector<fp_seconds> const& starts, drift_analysis const& drift) {
+            do_drift_analysis_complete(starts, drift);
+        }
 
         void benchmark_failure(std::exception_ptr error) {
             do_benchmark_failure(error);
         }
+        void benchmark_skipped() {
+            do_benchmark_skipped();
+        }
         void benchmark_complete() {
             do_benchmark_complete();
         }
+        void interference_check_complete(interference_check const& check) {
+            do_interference_check_complete(check);
+        }
 
         void params_complete() {
             do_params_complete();
@@ -115,6 +170,10 @@ namespace nonius {
 
         virtual std::string description() = 0;
 
+        // Whether the output is bytes rather than text; such reporters get their file opened in
+        // binary mode and cannot write to the console.
+        virtual bool binary_output() { return false; }
+
     private:
         virtual void do_configure(configuration& /*cfg*/) {}
 
@@ -127,18 +186,40 @@ namespace nonius {
         virtual void do_estimate_clock_cost_start() {}
         virtual void do_estimate_clock_cost_complete(environment_estimate<fp_seconds> /*estimate*/) {}
 
+        virtual void do_estimate_function_cost_start() {}
+        virtual void do_estimate_function_cost_complete(environment_estimate<fp_seconds> /*estimate*/) {}
+        // called instead of the estimate_*_start hooks when the environment was measured earlier,
+        // as with the environment cache or when merging results
+        virtual void do_environment_reused() {}
+
         virtual void do_suite_start() {}
+        virtual void do_time_budget_planned(time_budget_plan const& /*plan*/) {}
+        virtual void do_shard_planned(shard_plan const& /*plan*/) {}
         virtual void do_params_start(parameters const& /*params*/) {}
         virtual void do_benchmark_start(std::string const& /*name*/) {}
 
+        virtual void do_first_calls_complete(std::vector<fp_seconds> const& /*times*/) {}
+
         virtual void do_measurement_start(execution_plan<fp_seconds> /*plan*/) {}
         virtual void do_measurement_complete(std::vector<fp_seconds> const& /*samples*/) {}
+        // when each sample started, relative to the first one; reported even without analysis
+        virtual void do_sample_starts_complete(std::vector<fp_seconds> const& /*starts*/) {}
+        virtual void do_allocations_complete(allocation_stats const& /*stats*/) {}
+        virtual void do_resource_usage_complete(resource_usage const& /*usage*/) {}
+        virtual void do_frequency_complete(frequency_analysis const& /*frequency*/) {}
 
         virtual void do_analysis_start() {} // TODO make generic?
         virtual void do_analysis_complete(sample_analysis<fp_seconds> const& /*analysis*/) {}
+        virtual void do_drift_analysis_complete(std::vector<fp_seconds> const& /*starts*/, drift_analysis const& /*drift*/) {}
 
         virtual void do_benchmark_failure(std::exception_ptr /*error*/) {}
+        // ends a benchmark that was left out by the time budget; reporters that do not tell skipped
+        // benchmarks apart see a failure
+        virtual void do_benchmark_skipped() {
+            do_benchmark_failure(std::make_exception_ptr(time_budget_exceeded()));
+        }
         virtual void do_benchmark_complete() {}
+        virtual void do_interference_check_complete(interference_check const& /*check*/) {}
         virtual void do_params_complete() {}
         virtual void do_suite_complete() {}
 
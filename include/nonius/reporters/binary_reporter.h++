@@ -0,0 +1,176 @@
+// Nonius - C++ benchmarking tool
+//
+// Written in 2014- by the nonius contributors <nonius@rmf.io>
+//
+// To the extent possible under law, the author(s) have dedicated all copyright and related
+// and neighboring rights to this software to the public domain worldwide. This software is
+// distributed without any warranty.
+//
+// You should have received a copy of the CC0 Public Domain Dedication along with this software.
+// If not, see <http://creativecommons.org/publicdomain/zero/1.0/>
+
+// Binary results reporter
+
+#ifndef NONIUS_REPORTERS_BINARY_REPORTER_HPP
+#define NONIUS_REPORTERS_BINARY_REPORTER_HPP
+
+#include <nonius/reporter.h++>
+#include <nonius/configuration.h++>
+#include <nonius/sample_analysis.h++>
+#include <nonius/execution_plan.h++>
+#include <nonius/param.h++>
+#include <nonius/detail/binary_format.h++>
+#include <nonius/detail/plan_cache.h++>
+
+#ifdef NONIUS_USE_ZLIB
+#   include <zlib.h>
+#endif
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace nonius {
+    // Samples are written as each benchmark completes, deflated when NONIUS_USE_ZLIB is #defined
+    // and that makes them smaller; only the index, about a hundred bytes per benchmark, is kept
+    // until the end of the suite. See binary_results for reading.
+    struct binary_reporter : reporter {
+    private:
+        std::string description() override {
+            return "outputs results to a binary file that can be memory-mapped";
+        }
+        bool binary_output() override { return true; }
+
+        struct entry {
+            std::string name;
+            std::string params;
+            std::string failure;
+            detail::binary_record record;
+        };
+
+        void do_configure(configuration& /*cfg*/) override {
+            entries.clear();
+            offset = 0;
+            detail::binary_header header;
+            std::memcpy(header.magic, detail::binary_magic, sizeof(header.magic));
+            header.version = detail::binary_version;
+            header.byte_order = detail::binary_byte_order;
+            write(&header, sizeof(header));
+        }
+
+        void do_params_start(parameters const& params) override {
+            current_params = detail::params_key(params);
+        }
+        void do_benchmark_start(std::string const& name) override {
+            current = entry();
+            current.name = name;
+            current.params = current_params;
+            std::memset(&current.record, 0, sizeof(current.record));
+        }
+        void do_measurement_start(execution_plan<fp_seconds> plan) override {
+            current.record.iterations = static_cast<std::uint64_t>(plan.iterations_per_sample);
+        }
+        void do_measurement_complete(std::vector<fp_seconds> const& samples) override {
+            current.record.samples_offset = offset;
+            current.record.sample_count = samples.size();
+            static_assert(sizeof(fp_seconds) == sizeof(double), "fp_seconds must be a plain double");
+            auto size = samples.size() * sizeof(double);
+            auto deflated = compress_samples(samples.data(), size);
+            if(!deflated.empty() && deflated.size() < size) {
+                current.record.flags |= detail::binary_compressed;
+                current.record.samples_size = deflated.size();
+                write(deflated.data(), deflated.size());
+                pad();
+            } else {
+                current.record.samples_size = size;
+                write(samples.data(), size);
+            }
+            report_stream().flush();
+        }
+#ifdef NONIUS_USE_ZLIB
+        static std::vector<unsigned char> compress_samples(void const* data, std::size_t size) {
+            uLongf deflated_size = compressBound(static_cast<uLong>(size));
+            std::vector<unsigned char> deflated(deflated_size);
+            if(compress2(deflated.data(), &deflated_size, static_cast<Bytef const*>(data), static_cast<uLong>(size), Z_BEST_SPEED) != Z_OK) {
+                throw std::runtime_error("could not compress the samples for the binary report");
+            }
+            deflated.resize(deflated_size);
+            return deflated;
+        }
+#else
+        static std::vector<unsigned char> compress_samples(void const*, std::size_t) { return {}; }
+#endif
+        void do_analysis_complete(sample_analysis<fp_seconds> const& analysis) override {
+            current.record.flags |= detail::binary_analysed;
+            current.record.mean = analysis.mean.point.count();
+            current.record.mean_lower_bound = analysis.mean.lower_bound.count();
+            current.record.mean_upper_bound = analysis.mean.upper_bound.count();
+            current.record.standard_deviation = analysis.standard_deviation.point.count();
+        }
+        void do_benchmark_failure(std::exception_ptr error) override {
+            current.record.flags |= detail::binary_failed;
+            current.failure = "unknown error";
+            try {
+                std::rethrow_exception(error);
+            } catch(std::exception const& e) {
+                current.failure = e.what();
+            } catch(...) {}
+            entries.push_back(current);
+        }
+        void do_benchmark_complete() override {
+            entries.push_back(current);
+        }
+
+        void do_suite_complete() override {
+            std::sort(entries.begin(), entries.end(), [](entry const& a, entry const& b) {
+                return std::tie(a.name, a.params) < std::tie(b.name, b.params);
+            });
+            for(auto&& e : entries) {
+                e.record.name_offset = write_string(e.name);
+                e.record.name_size = static_cast<std::uint32_t>(e.name.size());
+                e.record.params_offset = write_string(e.params);
+                e.record.params_size = static_cast<std::uint32_t>(e.params.size());
+                e.record.failure_offset = write_string(e.failure);
+                e.record.failure_size = static_cast<std::uint32_t>(e.failure.size());
+            }
+            pad();
+
+            detail::binary_footer footer;
+            footer.index_offset = offset;
+            footer.record_count = entries.size();
+            std::memcpy(footer.magic, detail::binary_index_magic, sizeof(footer.magic));
+            for(auto&& e : entries) write(&e.record, sizeof(e.record));
+            write(&footer, sizeof(footer));
+            report_stream().flush();
+        }
+
+        void write(void const* data, std::size_t size) {
+            report_stream().write(static_cast<char const*>(data), static_cast<std::streamsize>(size));
+            offset += size;
+        }
+        std::uint64_t write_string(std::string const& s) {
+            auto at = offset;
+            write(s.data(), s.size());
+            return at;
+        }
+        void pad() {
+            static const char zeros[8] = {};
+            write(zeros, (8 - offset % 8) % 8);
+        }
+
+        std::vector<entry> entries;
+        entry current;
+        std::string current_params;
+        std::uint64_t offset = 0;
+    };
+
+    NONIUS_REPORTER("binary", binary_reporter);
+} // namespace nonius
+
+#endif // NONIUS_REPORTERS_BINARY_REPORTER_HPP
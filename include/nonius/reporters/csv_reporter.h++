@@ -19,20 +19,27 @@
 #include <nonius/sample_analysis.h++>
 #include <nonius/execution_plan.h++>
 #include <nonius/environment.h++>
+#include <nonius/frequency_analysis.h++>
+#include <nonius/param.h++>
 #include <nonius/detail/pretty_print.h++>
+#include <nonius/detail/format_number.h++>
 
-#include <ios>
-#include <iomanip>
 #include <ostream>
-#include <algorithm>
+#include <sstream>
 #include <string>
-#include <iterator>
 #include <exception>
-#include <limits>
-#include <unordered_map>
 #include <vector>
+#include <cstddef>
 
 namespace nonius {
+    namespace detail {
+        const std::size_t csv_flush_size = 1 << 16; // bytes
+    } // namespace detail
+
+    // One row per sample, written when each benchmark completes: the benchmark, the value of
+    // every parameter, the sample number and its time in seconds per iteration, then cycles
+    // per iteration if the frequency was measured, and the analysis of the benchmark (repeated
+    // on each of its rows) unless analysis is disabled.
     struct csv_reporter : reporter {
     private:
         std::string description() override {
@@ -40,9 +47,14 @@ namespace nonius {
         }
 
         void do_configure(configuration& cfg) override {
-            cfg.no_analysis = true;
             n_samples = cfg.samples;
             verbose = cfg.verbose;
+            cycles = cfg.frequency;
+            analysis = !cfg.no_analysis;
+            header_written = false;
+        }
+        void do_time_budget_planned(time_budget_plan const& plan) override {
+            n_samples = plan.samples;
         }
 
         void do_warmup_start() override {
@@ -55,80 +67,136 @@ namespace nonius {
             if(verbose) progress_stream() << "estimating cost of a clock call\n";
         }
 
+        void do_params_start(parameters const& params) override {
+            if(!header_written) {
+                header_written = true;
+                write_text("benchmark");
+                for(auto&& p : params) {
+                    buffer += ',';
+                    write_text(p.first);
+                }
+                buffer += ",\"sample\",\"seconds\"";
+                if(cycles) buffer += ",\"cycles\"";
+                if(analysis) buffer += ",\"mean\",\"mean_lower_bound\",\"mean_upper_bound\",\"standard_deviation\"";
+                buffer += '\n';
+                flush();
+            }
+            param_values.clear();
+            for(auto&& p : params) {
+                std::ostringstream ss;
+                ss << p.second;
+                param_values.push_back(ss.str());
+            }
+        }
+
         void do_benchmark_start(std::string const& name) override {
             if(verbose) progress_stream() << "\nbenchmarking " << name << "\n";
             current = name;
+            samples.clear();
+            cycles_per_iteration.clear();
+            analysed = false;
         }
 
         void do_measurement_start(execution_plan<fp_seconds> plan) override {
-            report_stream() << std::setprecision(7);
-            report_stream().unsetf(std::ios::floatfield);
             if(verbose) progress_stream() << "collecting " << n_samples << " samples, " << plan.iterations_per_sample << " iterations each, in estimated " << detail::pretty_duration(plan.estimated_duration) << "\n";
         }
-        void do_measurement_complete(std::vector<fp_seconds> const& samples) override {
-            data[current] = samples;
+        void do_measurement_complete(std::vector<fp_seconds> const& s) override {
+            samples = s;
+        }
+        void do_frequency_complete(frequency_analysis const& frequency) override {
+            cycles_per_iteration = frequency.cycles;
+        }
+        void do_analysis_complete(sample_analysis<fp_seconds> const& a) override {
+            analysed = true;
+            mean = a.mean;
+            standard_deviation = a.standard_deviation.point;
         }
 
         void do_benchmark_failure(std::exception_ptr) override {
             error_stream() << current << " failed to run successfully\n";
         }
-
-        void do_suite_complete() override {
-            if(verbose) progress_stream() << "\ngenerating CSV report\n";
-            report_stream() << std::fixed;
-            report_stream().precision(std::numeric_limits<double>::digits10);
-            bool first = true;
-            for(auto&& kv : data) {
-                if(!first) report_stream() << ",";
-                report_stream() << "\"" << escape(kv.first) << "\""; // TODO escape
-                first = false;
-            }
-            report_stream() << "\n";
-            for(int i = 0; i < n_samples; ++i) {
-                first = true;
-                for(auto&& kv : data) {
-                    if(!first) report_stream() << ",";
-                    report_stream() << kv.second[i].count();
-                    first = false;
+        void do_benchmark_skipped() override {
+            if(verbose) progress_stream() << "skipped: does not fit in the time budget\n";
+        }
+        void do_benchmark_complete() override {
+            for(std::size_t i = 0; i < samples.size(); ++i) {
+                write_text(current);
+                for(auto&& v : param_values) {
+                    buffer += ',';
+                    write_text(v);
+                }
+                buffer += ',';
+                write_integer(i);
+                buffer += ',';
+                write_number(samples[i].count());
+                if(cycles) {
+                    buffer += ',';
+                    if(i < cycles_per_iteration.size()) write_number(cycles_per_iteration[i]);
                 }
-                report_stream() << "\n";
+                if(analysis) {
+                    buffer += ',';
+                    if(analysed) {
+                        write_number(mean.point.count());
+                        buffer += ',';
+                        write_number(mean.lower_bound.count());
+                        buffer += ',';
+                        write_number(mean.upper_bound.count());
+                        buffer += ',';
+                        write_number(standard_deviation.count());
+                    } else {
+                        buffer += ",,,";
+                    }
+                }
+                buffer += '\n';
+                if(buffer.size() >= detail::csv_flush_size) flush();
             }
+            flush();
+        }
+
+        void do_suite_complete() override {
             if(verbose) progress_stream() << "done\n";
         }
 
-    private:
-        static std::string escape(std::string const& source) {
-            auto first = source.begin();
-            auto last = source.end();
-
-            auto quotes = std::count(first, last, '"');
-            if(quotes == 0) return source;
-
-            std::string escaped;
-            escaped.reserve(source.size() + quotes);
-
-            while(first != last) {
-                auto next_quote = std::find(first, last, '"');
-                std::copy(first, next_quote, std::back_inserter(escaped));
-                first = next_quote;
-                if(first != last) {
-                    ++first;
-                    escaped.push_back('"');
-                    escaped.push_back('"');
-                }
+        void write_text(std::string const& s) {
+            buffer += '"';
+            for(auto c : s) {
+                if(c == '"') buffer += '"';
+                buffer += c;
             }
-
-            return escaped;
+            buffer += '"';
+        }
+        void write_integer(std::size_t n) {
+            char digits[detail::format_number_size];
+            buffer.append(digits, detail::format_integer(n, digits));
+        }
+        void write_number(double x) {
+            char digits[detail::format_number_size];
+            buffer.append(digits, detail::format_number(x, digits));
+        }
+        void flush() {
+            report_stream().write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            report_stream().flush();
+            buffer.clear();
         }
 
         int n_samples;
         bool verbose;
+        bool cycles;
+        bool analysis;
+        bool header_written = false;
+
+        std::vector<std::string> param_values;
         std::string current;
-        std::unordered_map<std::string, std::vector<fp_seconds>> data;
+        std::vector<fp_seconds> samples;
+        std::vector<double> cycles_per_iteration;
+        bool analysed = false;
+        estimate<fp_seconds> mean;
+        fp_seconds standard_deviation;
+
+        std::string buffer;
     };
 
     NONIUS_REPORTER("csv", csv_reporter);
 } // namespace nonius
 
 #endif // NONIUS_REPORTERS_CSV_REPORTER_HPP
-
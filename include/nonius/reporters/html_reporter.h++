@@ -19,37 +19,54 @@
 #include <nonius/sample_analysis.h++>
 #include <nonius/execution_plan.h++>
 #include <nonius/environment.h++>
+#include <nonius/param.h++>
 #include <nonius/detail/pretty_print.h++>
 #include <nonius/detail/escape.h++>
-#include <nonius/detail/cpptempl.h>
+#include <nonius/detail/json.h++>
+#include <nonius/detail/format_number.h++>
+#include <nonius/detail/base64.h++>
+
+#ifdef NONIUS_USE_ZLIB
+#   include <zlib.h>
+#endif
 
 #include <ios>
 #include <iomanip>
 #include <algorithm>
+#include <sstream>
+#include <stdexcept>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <ostream>
 #include <exception>
 #include <cmath>
+#include <cstdint>
+#include <cstring>
 
 namespace nonius {
+    namespace detail {
+        // A piece of the report template: literal text, or the name of a hole to fill in.
+        struct html_template_part {
+            char const* text;
+            char const* hole;
+        };
+    } // namespace detail
+
+    // The report is streamed straight from the results into the holes of the template, which
+    // is split at build time by tools/stringize.py. Samples are not part of the script: each run
+    // gets an inert element with its samples as base64 little-endian float32 (deflated when
+    // NONIUS_USE_ZLIB is #defined), which the script only decodes when that run is plotted.
     struct html_reporter : reporter {
     private:
-        static std::string const& template_string() {
-            static char const* template_parts[] = {
+        static std::vector<detail::html_template_part> const& template_parts() {
+            static std::vector<detail::html_template_part> const parts {
 // generated content broken into pieces because MSVC is in the 1990s.
 #include <nonius/detail/html_report_template.g.h++>
             };
-            static std::string const the_template = []() -> std::string {
-                std::string s;
-                for(auto part : template_parts) {
-                    s += part;
-                }
-                return s;
-            }();
-            return the_template;
+            return parts;
         }
 
         std::string description() override {
@@ -63,6 +80,10 @@ namespace nonius {
             verbose = cfg.verbose;
             logarithmic = cfg.params.run && cfg.params.run->op == "*";
             run_param = cfg.params.run ? cfg.params.run->name : "";
+            runs.clear();
+        }
+        void do_time_budget_planned(time_budget_plan const& plan) override {
+            n_samples = plan.samples;
         }
 
         void do_warmup_start() override {
@@ -78,11 +99,16 @@ namespace nonius {
         void do_params_start(parameters const& params) override {
             if(verbose) progress_stream() << "\n\nnew parameter round\n" << params;
             runs.emplace_back();
-            runs.back().params = params;
+            for(auto&& p : params) {
+                std::ostringstream ss;
+                ss << p.second;
+                runs.back().params.emplace_back(p.first, ss.str());
+            }
         }
         void do_benchmark_start(std::string const& name) override {
             if(verbose) progress_stream() << "\nbenchmarking " << name << "\n";
-            current = runs.back().data.insert({name, {}}).first;
+            runs.back().benchmarks.emplace_back();
+            runs.back().benchmarks.back().name = name;
         }
 
         void do_measurement_start(execution_plan<fp_seconds> plan) override {
@@ -91,66 +117,150 @@ namespace nonius {
             if(verbose) progress_stream() << "collecting " << n_samples << " samples, " << plan.iterations_per_sample << " iterations each, in estimated " << detail::pretty_duration(plan.estimated_duration) << "\n";
         }
         void do_measurement_complete(std::vector<fp_seconds> const& samples) override {
-            current->second.samples = samples;
+            runs.back().benchmarks.back().samples = samples;
         }
         void do_analysis_complete(sample_analysis<fp_seconds> const& analysis) override {
-            current->second.analysis = analysis;
+            runs.back().benchmarks.back().mean = analysis.mean.point;
+            runs.back().benchmarks.back().stddev = analysis.standard_deviation.point;
+        }
+        void do_drift_analysis_complete(std::vector<fp_seconds> const& starts, drift_analysis const&) override {
+            runs.back().benchmarks.back().starts = starts;
         }
         void do_benchmark_failure(std::exception_ptr) override {
-            error_stream() << current->first << " failed to run successfully\n";
+            error_stream() << runs.back().benchmarks.back().name << " failed to run successfully\n";
+            mark_failed();
+        }
+        void do_benchmark_skipped() override {
+            if(verbose) progress_stream() << "skipped: does not fit in the time budget\n";
+            mark_failed();
+        }
+        // Failed benchmarks stay in the data without samples, so that every run lists the same
+        // benchmarks in the same order.
+        void mark_failed() {
+            auto&& b = runs.back().benchmarks.back();
+            auto name = std::move(b.name);
+            b = benchmark_t();
+            b.name = std::move(name);
+            b.failed = true;
         }
 
         void do_suite_complete() override {
             if(verbose) progress_stream() << "\ngenerating HTML report\n";
 
-            auto&& templ = template_string();
-            auto magnitude = ideal_magnitude();
-
-            cpptempl::data_map map;
-            map["title"] = escape(title);
-            map["units"] = detail::units_for_magnitude(magnitude);
-            map["logarithmic"] = logarithmic;
-            map["runparam"] = run_param;
-            for (auto&& r : runs) {
-                cpptempl::data_map run_item;
-                cpptempl::data_list params;
-                for (auto&& p : r.params) {
-                    cpptempl::data_map item;
-                    item["name"] = p.first;
-                    item["value"] = p.second;
-                    params.push_back(item);
+            magnitude = ideal_magnitude();
+            for(auto&& part : template_parts()) {
+                std::string hole = part.hole;
+                if(hole.empty()) report_stream() << part.text;
+                else if(hole == "title") report_stream() << escape(title);
+                else if(hole == "options") write_options();
+                else if(hole == "data") write_data();
+                else if(hole == "samples") write_samples();
+            }
+            report_stream() << std::flush;
+            if(verbose) progress_stream() << "done\n";
+        }
+
+        void write_options() {
+            for(std::size_t i = 0; i < runs.size(); ++i) {
+                std::string params;
+                for(auto&& p : runs[i].params) params += " | " + escape(p.first) + "=" + escape(p.second);
+                report_stream() << "<option value=\"" << i << "\">samples" << params << "</option>\n"
+                                << "<option value=\"t" << i << "\">samples over time" << params << "</option>\n";
+            }
+        }
+
+        void write_data() {
+            auto&& os = report_stream();
+            os << "{\n\"title\":";
+            detail::write_json_string(os, title, true);
+            os << ",\n\"units\":";
+            detail::write_json_string(os, detail::units_for_magnitude(magnitude), true);
+            os << ",\n\"logarithmic\":" << (logarithmic ? "true" : "false") << ",\n\"param\":";
+            detail::write_json_string(os, run_param, true);
+            os << ",\n\"compressed\":" << (compressed ? "true" : "false") << ",\n\"runs\":[";
+            for(auto&& r : runs) {
+                if(&r != &runs.front()) os << ',';
+                os << "{\n\"params\":{";
+                for(auto&& p : r.params) {
+                    if(&p != &r.params.front()) os << ',';
+                    detail::write_json_string(os, p.first, true);
+                    os << ':';
+                    detail::write_json_string(os, p.second, true);
                 }
-                run_item["params"] = cpptempl::make_data(params);
-                for(auto d : r.data) {
-                    cpptempl::data_map item;
-                    item["name"] = escape(d.first);
-                    item["mean"] = truncate(d.second.analysis.mean.point.count() * magnitude);
-                    item["stddev"] = truncate(d.second.analysis.standard_deviation.point.count() * magnitude);
-                    for(auto e : d.second.samples)
-                        item["samples"].push_back(truncate(e.count() * magnitude));
-                    run_item["benchmarks"].push_back(item);
+                os << "},\n\"benchmarks\":[";
+                for(auto&& b : r.benchmarks) {
+                    if(&b != &r.benchmarks.front()) os << ',';
+                    os << "{\n\"name\":";
+                    detail::write_json_string(os, b.name, true);
+                    os << ",\"failed\":" << (b.failed ? "true" : "false") << ",\"mean\":";
+                    write_number(truncate(b.mean.count() * magnitude));
+                    os << ",\"stddev\":";
+                    write_number(truncate(b.stddev.count() * magnitude));
+                    os << ",\"count\":" << b.samples.size() << ",\"startcount\":" << b.starts.size() << '}';
                 }
-                map["runs"].push_back(run_item);
+                os << "]}";
             }
+            os << "]\n}";
+        }
 
-            cpptempl::parse(report_stream(), templ, map);
-            report_stream() << std::flush;
-            if(verbose) progress_stream() << "done\n";
+        void write_number(double x) {
+            char digits[detail::format_number_size];
+            auto end = detail::format_number(x, digits);
+            report_stream().write(digits, end - digits);
+        }
+
+        // For each benchmark in order, its samples and then its start times, one run at a time
+        // so that only one run is ever held in memory as bytes.
+        void write_samples() {
+            for(std::size_t i = 0; i < runs.size(); ++i) {
+                std::vector<unsigned char> bytes;
+                for(auto&& b : runs[i].benchmarks) {
+                    append_floats(bytes, b.samples, magnitude);
+                    append_floats(bytes, b.starts, 1e3);
+                }
+                if(compressed) bytes = compress_samples(bytes);
+                report_stream() << "<script type=\"application/octet-stream\" id=\"samples" << i << "\">"
+                                << detail::base64_encode(bytes.data(), bytes.size()) << "</script>\n";
+            }
+        }
+        static void append_floats(std::vector<unsigned char>& bytes, std::vector<fp_seconds> const& durations, double scale) {
+            bytes.reserve(bytes.size() + durations.size() * 4);
+            for(auto&& d : durations) {
+                float f = static_cast<float>(d.count() * scale);
+                std::uint32_t bits;
+                std::memcpy(&bits, &f, sizeof(bits));
+                for(int shift = 0; shift < 32; shift += 8) {
+                    bytes.push_back(static_cast<unsigned char>(bits >> shift));
+                }
+            }
+        }
+#ifdef NONIUS_USE_ZLIB
+        static std::vector<unsigned char> compress_samples(std::vector<unsigned char> const& bytes) {
+            uLongf size = compressBound(static_cast<uLong>(bytes.size()));
+            std::vector<unsigned char> deflated(size);
+            if(compress2(deflated.data(), &size, bytes.data(), static_cast<uLong>(bytes.size()), Z_BEST_SPEED) != Z_OK) {
+                throw std::runtime_error("could not compress the samples for the HTML report");
+            }
+            deflated.resize(size);
+            return deflated;
         }
+        static constexpr bool compressed = true;
+#else
+        static std::vector<unsigned char> compress_samples(std::vector<unsigned char> const& bytes) { return bytes; }
+        static constexpr bool compressed = false;
+#endif
 
         static double truncate(double x) {
             return std::trunc(x * 1000.) / 1000.;
         }
 
         double ideal_magnitude() const {
-            std::vector<fp_seconds> mins;
-            mins.reserve(runs.size() * runs.front().data.size());
-            for (auto&& r : runs) {
-                for(auto d : r.data) {
-                    mins.push_back(*std::min_element(d.second.samples.begin(), d.second.samples.end()));
+            auto min = fp_seconds(std::numeric_limits<double>::infinity());
+            for(auto&& r : runs) {
+                for(auto&& b : r.benchmarks) {
+                    if(!b.samples.empty()) min = std::min(min, *std::min_element(b.samples.begin(), b.samples.end()));
                 }
             }
-            auto min = *std::min_element(mins.begin(), mins.end());
             return detail::get_magnitude(min);
         }
 
@@ -161,19 +271,22 @@ namespace nonius {
                 { '<',  "&lt;"   },
                 { '>',  "&gt;"   },
                 { '&',  "&amp;"  },
-                { '\\',  "\\\\"  },
             };
             return detail::escape(source, escapes);
         }
 
-        struct result_t {
+        struct benchmark_t {
+            std::string name;
             std::vector<fp_seconds> samples;
-            sample_analysis<fp_seconds> analysis;
+            std::vector<fp_seconds> starts;
+            fp_seconds mean = fp_seconds::zero();
+            fp_seconds stddev = fp_seconds::zero();
+            bool failed = false;
         };
 
         struct run_t {
-            parameters params;
-            std::unordered_map<std::string, result_t> data;
+            std::vector<std::pair<std::string, std::string>> params;
+            std::vector<benchmark_t> benchmarks;
         };
 
         int n_samples;
@@ -182,7 +295,7 @@ namespace nonius {
         bool logarithmic;
         std::string run_param;
         std::vector<run_t> runs;
-        typename std::unordered_map<std::string, result_t>::iterator current;
+        double magnitude = 1.;
     };
 
     NONIUS_REPORTER("html", html_reporter);
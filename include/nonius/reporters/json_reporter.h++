@@ -0,0 +1,285 @@
+// Nonius - C++ benchmarking tool
+//
+// Written in 2014- by the nonius contributors <nonius@rmf.io>
+//
+// To the extent possible under law, the author(s) have dedicated all copyright and related
+// and neighboring rights to this software to the public domain worldwide. This software is
+// distributed without any warranty.
+//
+// You should have received a copy of the CC0 Public Domain Dedication along with this software.
+// If not, see <http://creativecommons.org/publicdomain/zero/1.0/>
+
+// Newline-delimited JSON reporter
+
+#ifndef NONIUS_REPORTERS_JSON_REPORTER_HPP
+#define NONIUS_REPORTERS_JSON_REPORTER_HPP
+
+#include <nonius/reporter.h++>
+#include <nonius/configuration.h++>
+#include <nonius/sample_analysis.h++>
+#include <nonius/execution_plan.h++>
+#include <nonius/environment.h++>
+#include <nonius/estimate.h++>
+#include <nonius/outlier_classification.h++>
+#include <nonius/param.h++>
+#include <nonius/detail/json.h++>
+
+#include <exception>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace nonius {
+    // One JSON object per line for each reporter event, written and flushed as it happens, so
+    // the file can be followed while the suite runs. Nothing is kept between events. Durations
+    // are in seconds.
+    struct json_reporter : reporter {
+    private:
+        std::string description() override {
+            return "outputs every event as a line of JSON";
+        }
+
+        void do_configure(configuration& cfg) override {
+            begin("configure");
+            field("title"); string(cfg.title);
+            field("samples"); report_stream() << cfg.samples;
+            field("resamples"); report_stream() << cfg.resamples;
+            field("confidence_interval"); number(cfg.confidence_interval);
+            field("no_analysis"); boolean(cfg.no_analysis);
+            end();
+        }
+
+        void do_warmup_end(int iterations) override {
+            begin("warmup");
+            field("iterations"); report_stream() << iterations;
+            end();
+        }
+        void do_estimate_clock_resolution_complete(environment_estimate<fp_seconds> estimate) override {
+            environment_event("clock_resolution", estimate);
+        }
+        void do_estimate_clock_cost_complete(environment_estimate<fp_seconds> estimate) override {
+            environment_event("clock_cost", estimate);
+        }
+        void do_estimate_function_cost_complete(environment_estimate<fp_seconds> estimate) override {
+            environment_event("function_cost", estimate);
+        }
+        void do_environment_reused() override {
+            begin("environment_reused");
+            end();
+        }
+
+        void do_suite_start() override {
+            begin("suite_start");
+            end();
+        }
+        void do_time_budget_planned(time_budget_plan const& plan) override {
+            begin("time_budget");
+            field("budget"); number(plan.budget.count());
+            field("estimated"); number(plan.estimated.count());
+            field("samples"); report_stream() << plan.samples;
+            field("skipped"); report_stream() << plan.skipped;
+            end();
+        }
+        void do_shard_planned(shard_plan const& plan) override {
+            begin("shard");
+            field("index"); report_stream() << plan.index;
+            field("count"); report_stream() << plan.count;
+            field("rounds"); report_stream() << plan.rounds;
+            field("benchmarks"); array(plan.benchmarks, [this](std::string const& s) { string(s); });
+            field("assignment"); array(plan.assignment, [this](int i) { report_stream() << i; });
+            field("estimated"); number(plan.estimated.count());
+            end();
+        }
+
+        void do_params_start(parameters const& params) override {
+            begin("params_start");
+            field("params");
+            report_stream() << '{';
+            bool first = true;
+            for(auto&& p : params) {
+                if(!first) report_stream() << ',';
+                first = false;
+                std::ostringstream value;
+                value << p.second;
+                string(p.first);
+                report_stream() << ':';
+                string(value.str());
+            }
+            report_stream() << '}';
+            end();
+        }
+        void do_benchmark_start(std::string const& name) override {
+            current = name;
+            benchmark_event("benchmark_start");
+            end();
+        }
+
+        void do_first_calls_complete(std::vector<fp_seconds> const& times) override {
+            benchmark_event("first_calls");
+            field("times"); durations(times);
+            end();
+        }
+        void do_measurement_start(execution_plan<fp_seconds> plan) override {
+            benchmark_event("plan");
+            field("iterations"); report_stream() << plan.iterations_per_sample;
+            field("estimated"); number(plan.estimated_duration.count());
+            field("warmup_time"); number(plan.warmup_time.count());
+            field("warmup_window"); report_stream() << plan.warmup_window;
+            end();
+        }
+        void do_measurement_complete(std::vector<fp_seconds> const& samples) override {
+            benchmark_event("samples");
+            field("samples"); durations(samples);
+            end();
+        }
+        void do_sample_starts_complete(std::vector<fp_seconds> const& starts) override {
+            benchmark_event("sample_starts");
+            field("starts"); durations(starts);
+            end();
+        }
+        void do_allocations_complete(allocation_stats const& stats) override {
+            benchmark_event("allocations");
+            field("calls"); report_stream() << stats.calls;
+            field("bytes"); report_stream() << stats.bytes;
+            field("peak_bytes"); report_stream() << stats.peak_bytes;
+            field("iterations"); report_stream() << stats.iterations;
+            end();
+        }
+        void do_resource_usage_complete(resource_usage const& usage) override {
+            benchmark_event("resource_usage");
+            field("user_time"); number(usage.user_time.count());
+            field("system_time"); number(usage.system_time.count());
+            field("max_rss_growth"); report_stream() << usage.max_rss_growth;
+            field("minor_faults"); report_stream() << usage.minor_faults;
+            field("major_faults"); report_stream() << usage.major_faults;
+            field("voluntary_context_switches"); report_stream() << usage.voluntary_context_switches;
+            field("involuntary_context_switches"); report_stream() << usage.involuntary_context_switches;
+            end();
+        }
+        void do_frequency_complete(frequency_analysis const& frequency) override {
+            benchmark_event("frequency");
+            field("source"); string(frequency.source == frequency_source::perf_counters ? "perf_counters" : "spin_loop");
+            field("nominal"); number(frequency.nominal);
+            field("frequencies"); array(frequency.frequencies, [this](double x) { number(x); });
+            field("cycles"); array(frequency.cycles, [this](double x) { number(x); });
+            field("normalized"); durations(frequency.normalized);
+            field("degraded"); array(frequency.degraded, [this](bool b) { boolean(b); });
+            end();
+        }
+
+        void do_analysis_complete(sample_analysis<fp_seconds> const& analysis) override {
+            benchmark_event("analysis");
+            field("mean"); estimate(analysis.mean);
+            field("standard_deviation"); estimate(analysis.standard_deviation);
+            field("outliers"); outliers(analysis.outliers);
+            field("outlier_variance"); number(analysis.outlier_variance);
+            end();
+        }
+        void do_drift_analysis_complete(std::vector<fp_seconds> const& starts, drift_analysis const& drift) override {
+            benchmark_event("drift");
+            field("starts"); durations(starts);
+            field("trend_z"); number(drift.trend_z);
+            field("trend_p"); number(drift.trend_p);
+            field("trend"); number(drift.trend);
+            field("change_point"); report_stream() << drift.change_point;
+            field("shift"); number(drift.shift);
+            field("stationary"); boolean(drift.stationary);
+            end();
+        }
+
+        void do_benchmark_failure(std::exception_ptr error) override {
+            std::string message = "unknown error";
+            try {
+                std::rethrow_exception(error);
+            } catch(std::exception const& e) {
+                message = e.what();
+            } catch(...) {}
+            benchmark_event("failure");
+            field("message"); string(message);
+            end();
+        }
+        void do_benchmark_skipped() override {
+            benchmark_event("skipped");
+            end();
+        }
+        void do_benchmark_complete() override {
+            benchmark_event("benchmark_complete");
+            end();
+        }
+        void do_interference_check_complete(interference_check const& check) override {
+            begin("interference_check");
+            field("benchmark"); string(check.benchmark);
+            field("parallel"); number(check.parallel.count());
+            field("serial"); number(check.serial.count());
+            end();
+        }
+        void do_params_complete() override {
+            begin("params_complete");
+            end();
+        }
+        void do_suite_complete() override {
+            begin("suite_complete");
+            end();
+        }
+
+        void begin(char const* event) {
+            report_stream() << "{\"event\":\"" << event << '"';
+        }
+        void benchmark_event(char const* event) {
+            begin(event);
+            field("benchmark"); string(current);
+        }
+        void field(char const* name) {
+            report_stream() << ",\"" << name << "\":";
+        }
+        void end() {
+            report_stream() << "}\n" << std::flush;
+        }
+
+        void string(std::string const& s) { detail::write_json_string(report_stream(), s); }
+        void number(double x) { detail::write_json_number(report_stream(), x); }
+        void boolean(bool b) { report_stream() << (b ? "true" : "false"); }
+
+        template <typename Range, typename Write>
+        void array(Range const& range, Write write) {
+            report_stream() << '[';
+            bool first = true;
+            for(auto&& x : range) {
+                if(!first) report_stream() << ',';
+                first = false;
+                write(x);
+            }
+            report_stream() << ']';
+        }
+        void durations(std::vector<fp_seconds> const& ds) {
+            array(ds, [this](fp_seconds d) { number(d.count()); });
+        }
+        void estimate(nonius::estimate<fp_seconds> const& e) {
+            report_stream() << "{\"point\":"; number(e.point.count());
+            report_stream() << ",\"lower_bound\":"; number(e.lower_bound.count());
+            report_stream() << ",\"upper_bound\":"; number(e.upper_bound.count());
+            report_stream() << ",\"confidence_interval\":"; number(e.confidence_interval);
+            report_stream() << '}';
+        }
+        void outliers(outlier_classification const& o) {
+            report_stream() << "{\"samples_seen\":" << o.samples_seen
+                            << ",\"low_severe\":" << o.low_severe
+                            << ",\"low_mild\":" << o.low_mild
+                            << ",\"high_mild\":" << o.high_mild
+                            << ",\"high_severe\":" << o.high_severe << '}';
+        }
+        void environment_event(char const* event, environment_estimate<fp_seconds> const& estimate) {
+            begin(event);
+            field("mean"); number(estimate.mean.count());
+            field("outliers"); outliers(estimate.outliers);
+            end();
+        }
+
+        std::string current;
+    };
+
+    NONIUS_REPORTER("json", json_reporter);
+} // namespace nonius
+
+#endif // NONIUS_REPORTERS_JSON_REPORTER_HPP
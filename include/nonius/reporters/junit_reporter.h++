@@ -46,10 +46,14 @@ namespace nonius {
             verbose = cfg.verbose;
             title = cfg.title;
         }
+        void do_time_budget_planned(time_budget_plan const& plan) override {
+            n_samples = plan.samples;
+        }
 
         struct result {
             sample_analysis<fp_seconds> analysis;
             std::exception_ptr failure;
+            bool skipped;
         };
 
         void do_warmup_start() override {
@@ -77,13 +81,16 @@ namespace nonius {
             if(verbose) report_stream() << "analysing samples\n";
         }
         void do_analysis_complete(sample_analysis<fp_seconds> const& analysis) override {
-            data[current] = { analysis, nullptr };
+            data[current] = { analysis, nullptr, false };
         }
 
         void do_benchmark_failure(std::exception_ptr e) override {
-            data[current] = { sample_analysis<fp_seconds>(), e };
+            data[current] = { sample_analysis<fp_seconds>(), e, false };
             error_stream() << current << " failed to run successfully\n";
         }
+        void do_benchmark_skipped() override {
+            data[current] = { sample_analysis<fp_seconds>(), nullptr, true };
+        }
 
         void do_suite_complete() override {
             if(verbose) progress_stream() << "\ngenerating JUnit report\n";
@@ -95,6 +102,11 @@ namespace nonius {
                         return static_cast<bool>(p.second.failure);
                     });
             if(failures > 0) report_stream() << " errors=\"" << failures << "\"";
+            auto skipped = std::count_if(data.begin(), data.end(),
+                    [](std::pair<std::string const&, result> const& p) {
+                        return p.second.skipped;
+                    });
+            if(skipped > 0) report_stream() << " skipped=\"" << skipped << "\"";
             report_stream() << ">\n";
 
             report_stream() << " <properties>\n";
@@ -115,6 +127,10 @@ namespace nonius {
                         report_stream() << "  <error message=\"unknown error\" />\n";
                     }
                     report_stream() << " </testcase>\n";
+                } else if(tc.second.skipped) {
+                    report_stream() << ">\n";
+                    report_stream() << "  <skipped message=\"does not fit in the time budget\" />\n";
+                    report_stream() << " </testcase>\n";
                 } else {
                     report_stream() << std::fixed;
                     report_stream().precision(std::numeric_limits<double>::digits10);
@@ -0,0 +1,138 @@
+// Nonius - C++ benchmarking tool
+//
+// Written in 2014- by the nonius contributors <nonius@rmf.io>
+//
+// To the extent possible under law, the author(s) have dedicated all copyright and related
+// and neighboring rights to this software to the public domain worldwide. This software is
+// distributed without any warranty.
+//
+// You should have received a copy of the CC0 Public Domain Dedication along with this software.
+// If not, see <http://creativecommons.org/publicdomain/zero/1.0/>
+
+// Raw results reporter, for merging shards
+
+#ifndef NONIUS_REPORTERS_RAW_REPORTER_HPP
+#define NONIUS_REPORTERS_RAW_REPORTER_HPP
+
+#include <nonius/reporter.h++>
+#include <nonius/configuration.h++>
+#include <nonius/execution_plan.h++>
+#include <nonius/environment.h++>
+#include <nonius/detail/plan_cache.h++>
+#include <nonius/detail/shard.h++>
+
+#include <algorithm>
+#include <exception>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <cstddef>
+
+namespace nonius {
+    // One record per line, with tab separated fields escaped as in the plan cache. Records are
+    // written as the run goes, so an interrupted run still leaves the complete benchmarks behind.
+    struct raw_reporter : reporter {
+    private:
+        std::string description() override {
+            return "outputs raw results for --merge";
+        }
+
+        void do_configure(configuration& cfg) override {
+            cfg.no_analysis = true; // done when merging
+            suite.clear();
+            round = -1;
+            report_stream().precision(17);
+            report_stream() << "nonius-raw\t1\n";
+            report_stream() << "samples\t" << cfg.samples << "\n";
+            report_stream() << "resamples\t" << cfg.resamples << "\n";
+            report_stream() << "confidence_interval\t" << cfg.confidence_interval << "\n";
+        }
+
+        void do_estimate_clock_resolution_complete(environment_estimate<fp_seconds> estimate) override {
+            write_estimate("clock_resolution", estimate);
+        }
+        void do_estimate_clock_cost_complete(environment_estimate<fp_seconds> estimate) override {
+            write_estimate("clock_cost", estimate);
+        }
+        void do_estimate_function_cost_complete(environment_estimate<fp_seconds> estimate) override {
+            write_estimate("function_cost", estimate);
+        }
+
+        void do_shard_planned(shard_plan const& plan) override {
+            suite = plan.benchmarks;
+            report_stream() << "shard\t" << plan.index << '\t' << plan.count << '\t' << plan.rounds;
+            for(auto&& name : suite) report_stream() << '\t' << detail::escape_field(name);
+            report_stream() << '\n';
+        }
+
+        void do_params_start(parameters const& params) override {
+            ++round;
+            position = 0;
+            report_stream() << "params\t" << round << '\t' << detail::escape_field(detail::params_key(params)) << '\n';
+        }
+        void do_benchmark_start(std::string const& name) override {
+            auto it = std::find(suite.begin(), suite.end(), name);
+            if(it != suite.end()) position = static_cast<std::size_t>(it - suite.begin());
+            report_stream() << "benchmark\t" << round << '\t' << position++ << '\t' << detail::escape_field(name) << '\n';
+        }
+
+        void do_first_calls_complete(std::vector<fp_seconds> const& times) override {
+            write_durations("first_calls", times);
+        }
+        void do_measurement_start(execution_plan<fp_seconds> plan) override {
+            report_stream() << "plan\t" << plan.iterations_per_sample << '\t' << plan.estimated_duration.count() << '\n';
+        }
+        void do_measurement_complete(std::vector<fp_seconds> const& samples) override {
+            write_durations("measurement", samples);
+        }
+        void do_sample_starts_complete(std::vector<fp_seconds> const& starts) override {
+            write_durations("starts", starts);
+        }
+        void do_allocations_complete(allocation_stats const& stats) override {
+            report_stream() << "allocations\t" << stats.calls << '\t' << stats.bytes << '\t' << stats.peak_bytes << '\t' << stats.iterations << '\n';
+        }
+        void do_resource_usage_complete(resource_usage const& usage) override {
+            report_stream() << "resource_usage\t" << usage.user_time.count() << '\t' << usage.system_time.count() << '\t' << usage.max_rss_growth
+                            << '\t' << usage.minor_faults << '\t' << usage.major_faults
+                            << '\t' << usage.voluntary_context_switches << '\t' << usage.involuntary_context_switches << '\n';
+        }
+        void do_frequency_complete(frequency_analysis const& frequency) override {
+            // the rest of the analysis follows from these and the samples
+            report_stream() << "frequency\t" << static_cast<char>(frequency.source) << '\t' << frequency.nominal;
+            for(auto f : frequency.frequencies) report_stream() << '\t' << f;
+            report_stream() << '\n';
+        }
+
+        void do_benchmark_failure(std::exception_ptr error) override {
+            std::string message = "unknown error";
+            try {
+                std::rethrow_exception(error);
+            } catch(std::exception const& e) {
+                message = e.what();
+            } catch(...) {}
+            report_stream() << "failure\t" << detail::escape_field(message) << std::endl;
+        }
+        void do_benchmark_complete() override {
+            report_stream() << "complete" << std::endl;
+        }
+
+        void write_estimate(char const* name, environment_estimate<fp_seconds> const& estimate) {
+            auto&& o = estimate.outliers;
+            report_stream() << name << '\t' << estimate.mean.count() << '\t' << o.samples_seen << '\t' << o.low_severe
+                            << '\t' << o.low_mild << '\t' << o.high_mild << '\t' << o.high_severe << '\n';
+        }
+        void write_durations(char const* name, std::vector<fp_seconds> const& durations) {
+            report_stream() << name;
+            for(auto d : durations) report_stream() << '\t' << d.count();
+            report_stream() << '\n';
+        }
+
+        std::vector<std::string> suite;
+        int round = -1;
+        std::size_t position = 0;
+    };
+
+    NONIUS_REPORTER("raw", raw_reporter);
+} // namespace nonius
+
+#endif // NONIUS_REPORTERS_RAW_REPORTER_HPP
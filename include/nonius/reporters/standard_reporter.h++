@@ -15,17 +15,25 @@
 #define NONIUS_REPORTERS_STANDARD_REPORTER_HPP
 
 #include <nonius/reporter.h++>
+#include <nonius/benchmark.h++>
 #include <nonius/configuration.h++>
 #include <nonius/sample_analysis.h++>
 #include <nonius/execution_plan.h++>
 #include <nonius/environment.h++>
+#include <nonius/resource_usage.h++>
+#include <nonius/frequency_analysis.h++>
 #include <nonius/clock.h++>
+#include <nonius/detail/drift.h++>
 #include <nonius/detail/pretty_print.h++>
 
 #include <ios>
+#include <algorithm>
+#include <numeric>
+#include <vector>
 #include <iomanip>
 #include <string>
 #include <exception>
+#include <cmath>
 
 namespace nonius {
     struct standard_reporter : reporter {
@@ -36,6 +44,9 @@ namespace nonius {
 
         void do_configure(configuration& cfg) override {
             n_samples = cfg.samples;
+            target_rel_ci = cfg.target_rel_ci;
+            cold = cfg.cache != cache_mode::warm;
+            single_runs = cfg.cache == cache_mode::cold_iteration;
             verbose = cfg.verbose;
             summary = cfg.summary;
             n_resamples = cfg.resamples;
@@ -48,9 +59,14 @@ namespace nonius {
         void do_estimate_clock_resolution_start() override {
             if(verbose) report_stream() << "estimating clock resolution\n";
         }
+        void do_environment_reused() override {
+            reused_environment = true;
+            if(verbose) report_stream() << "reusing an earlier measurement of the environment\n";
+        }
         void do_estimate_clock_resolution_complete(environment_estimate<fp_seconds> estimate) override {
+            resolution = estimate.mean;
             if(!summary) {
-                if(!verbose) report_stream() << "clock resolution: ";
+                if(!verbose || reused_environment) report_stream() << "clock resolution: ";
                 print_environment_estimate(estimate, estimate.outliers.samples_seen + 2);
             }
         }
@@ -59,7 +75,39 @@ namespace nonius {
             if(verbose) report_stream() << "estimating cost of a clock call\n";
         }
         void do_estimate_clock_cost_complete(environment_estimate<fp_seconds> estimate) override {
-            if(verbose) print_environment_estimate(estimate, estimate.outliers.samples_seen);
+            if(!verbose) return;
+            if(reused_environment) report_stream() << "cost of a clock call: ";
+            print_environment_estimate(estimate, estimate.outliers.samples_seen);
+        }
+
+        void do_estimate_function_cost_start() override {
+            if(verbose) report_stream() << "estimating cost of running a sample\n";
+        }
+        void do_estimate_function_cost_complete(environment_estimate<fp_seconds> estimate) override {
+            if(!verbose) return;
+            if(reused_environment) report_stream() << "cost of running a sample: ";
+            print_environment_estimate(estimate, estimate.outliers.samples_seen);
+        }
+
+        void do_time_budget_planned(time_budget_plan const& plan) override {
+            n_samples = plan.samples;
+            if(summary) return;
+            report_stream() << std::setprecision(7);
+            report_stream().unsetf(std::ios::floatfield);
+            report_stream() << "time budget: " << detail::pretty_duration(plan.budget) << ", estimated " << detail::pretty_duration(plan.estimated)
+                            << " with " << plan.samples << " samples per benchmark";
+            if(plan.skipped > 0) report_stream() << ", skipping " << plan.skipped << " benchmarks";
+            report_stream() << "\n";
+        }
+
+        void do_shard_planned(shard_plan const& plan) override {
+            if(summary) return;
+            auto mine = std::count(plan.assignment.begin(), plan.assignment.end(), plan.index);
+            report_stream() << std::setprecision(7);
+            report_stream().unsetf(std::ios::floatfield);
+            report_stream() << "shard " << plan.index << " of " << plan.count << ": " << mine << " of " << plan.assignment.size() << " benchmarks";
+            if(plan.estimated > fp_seconds::zero()) report_stream() << ", estimated " << detail::pretty_duration(plan.estimated) << " of sampling";
+            report_stream() << "\n";
         }
 
         void do_params_start(parameters const& params) override {
@@ -72,10 +120,96 @@ namespace nonius {
             current = name;
         }
 
+        void do_first_calls_complete(std::vector<fp_seconds> const& times) override {
+            if(times.empty()) return;
+            report_stream() << std::setprecision(7);
+            report_stream().unsetf(std::ios::floatfield);
+            report_stream() << "first call: " << detail::pretty_duration(times.front());
+            if(times.size() > 1) {
+                auto minmax = std::minmax_element(times.begin(), times.end());
+                auto total = std::accumulate(times.begin(), times.end(), fp_seconds::zero());
+                report_stream() << "; first " << times.size() << " calls: mean " << detail::pretty_duration(total / times.size())
+                                << ", min " << detail::pretty_duration(*minmax.first)
+                                << ", max " << detail::pretty_duration(*minmax.second);
+            }
+            report_stream() << "\n";
+            if(verbose) {
+                for(auto&& t : times) report_stream() << "  " << detail::pretty_duration(t) << "\n";
+            }
+        }
+
         void do_measurement_start(execution_plan<fp_seconds> plan) override {
             report_stream() << std::setprecision(7);
             report_stream().unsetf(std::ios::floatfield);
-            if(!summary) report_stream() << "collecting " << n_samples << " samples, " << plan.iterations_per_sample << " iterations each, in estimated " << detail::pretty_duration(plan.estimated_duration) << "\n";
+            if(!summary) {
+                if(target_rel_ci > 0) {
+                    report_stream() << "collecting samples until the mean is known within ±" << detail::percentage(target_rel_ci)
+                                    << ", " << plan.iterations_per_sample << " iterations each";
+                    if(cold) report_stream() << ", with cold caches";
+                    report_stream() << "\n";
+                } else {
+                    report_stream() << "collecting " << n_samples << " samples, " << plan.iterations_per_sample << " iterations each, ";
+                    if(cold) report_stream() << "with cold caches, ";
+                    report_stream() << "in estimated " << detail::pretty_duration(plan.estimated_duration) << "\n";
+                }
+                // single runs cannot be repeated until they span enough clock ticks
+                auto run_time = plan.estimated_duration / (static_cast<double>(plan.iterations_per_sample) * std::max(n_samples, 1));
+                if(single_runs && run_time < resolution * detail::minimum_ticks) {
+                    report_stream() << "warning: a single run takes about " << detail::pretty_duration(run_time)
+                                    << ", too close to the clock resolution of " << detail::pretty_duration(resolution) << " to be timed precisely\n";
+                }
+            }
+        }
+        void do_measurement_complete(std::vector<fp_seconds> const& samples) override {
+            if(!summary && target_rel_ci > 0) report_stream() << "collected " << samples.size() << " samples\n";
+        }
+        void do_allocations_complete(allocation_stats const& stats) override {
+            if(summary) return;
+            report_stream() << std::setprecision(7);
+            report_stream().unsetf(std::ios::floatfield);
+            report_stream() << "allocations: " << stats.calls_per_iteration() << " per iteration, "
+                            << stats.bytes_per_iteration() << " bytes per iteration, peak " << stats.peak_bytes << " bytes\n";
+        }
+        void do_resource_usage_complete(resource_usage const& usage) override {
+            if(summary || !verbose) return;
+            report_stream() << std::setprecision(7);
+            report_stream().unsetf(std::ios::floatfield);
+            report_stream() << "cpu time: user " << detail::pretty_duration(usage.user_time)
+                            << ", system " << detail::pretty_duration(usage.system_time) << "\n";
+            report_stream() << "max RSS growth: " << usage.max_rss_growth / 1024 << " KiB, page faults: "
+                            << usage.minor_faults << " minor, " << usage.major_faults << " major\n";
+            report_stream() << "context switches: " << usage.voluntary_context_switches << " voluntary, "
+                            << usage.involuntary_context_switches << " involuntary\n";
+        }
+        void do_frequency_complete(frequency_analysis const& frequency) override {
+            if(summary || frequency.frequencies.empty()) return;
+            auto mean = [](std::vector<double> const& v) { return std::accumulate(v.begin(), v.end(), 0.) / v.size(); };
+            report_stream() << std::setprecision(3) << std::fixed;
+            report_stream() << "effective frequency: " << mean(frequency.frequencies) / 1e9 << " GHz";
+            if(frequency.nominal > 0) report_stream() << " (nominal " << frequency.nominal / 1e9 << " GHz)";
+            report_stream() << (frequency.source == frequency_source::perf_counters ? ", from cycle counters\n" : ", estimated with a spin loop\n");
+            report_stream() << std::setprecision(1);
+            report_stream() << "cycles per iteration: " << mean(frequency.cycles) << "\n";
+            report_stream().unsetf(std::ios::floatfield);
+            report_stream() << std::setprecision(7);
+            if(!frequency.normalized.empty()) {
+                auto normalized = std::accumulate(frequency.normalized.begin(), frequency.normalized.end(), fp_seconds::zero()) / frequency.normalized.size();
+                report_stream() << "time at nominal frequency: " << detail::pretty_duration(normalized) << " mean\n";
+            }
+            auto degraded = std::count(frequency.degraded.begin(), frequency.degraded.end(), true);
+            if(degraded > 0) {
+                report_stream() << "warning: " << degraded << " of " << frequency.degraded.size() << " samples were taken at a degraded frequency\n";
+            }
+        }
+        void do_interference_check_complete(interference_check const& check) override {
+            auto difference = check.serial > fp_seconds::zero() ? check.parallel / check.serial - 1 : 0.;
+            bool interfered = std::abs(difference) > detail::interference_threshold;
+            if(summary && !interfered) return;
+            report_stream() << std::setprecision(7);
+            report_stream().unsetf(std::ios::floatfield);
+            report_stream() << '\n' << (interfered ? "warning: " : "") << "interference check for " << check.benchmark << ": mean "
+                            << detail::pretty_duration(check.parallel) << " alongside other jobs, " << detail::pretty_duration(check.serial)
+                            << " on its own (" << signed_percentage(difference) << ")\n";
         }
         void do_analysis_start() override {
             if(verbose) report_stream() << "bootstrapping with " << n_resamples << " resamples\n";
@@ -93,6 +227,9 @@ namespace nonius {
             }
             report_stream() << "\nbenchmark aborted\n";
         }
+        void do_benchmark_skipped() override {
+            report_stream() << "skipped: does not fit in the time budget\n";
+        }
         void do_analysis_complete(sample_analysis<fp_seconds> const& analysis) override {
             print_statistic_estimate("mean", analysis.mean);
             print_statistic_estimate("std dev", analysis.standard_deviation);
@@ -110,6 +247,26 @@ namespace nonius {
             }
             report_stream() << "variance is " << effect << " by outliers\n";
         }
+        void do_drift_analysis_complete(std::vector<fp_seconds> const&, drift_analysis const& drift) override {
+            if(summary) return;
+            report_stream() << std::setprecision(3);
+            if(drift.stationary) {
+                if(verbose) report_stream() << "no drift over time (trend p = " << drift.trend_p << ")\n";
+                return;
+            }
+            report_stream() << "warning: samples drift over time:";
+            char const* separator = " ";
+            if(drift.trend_p < detail::drift_significance) {
+                report_stream() << separator << "trend of " << signed_percentage(drift.trend) << " (p = " << drift.trend_p << ")";
+                separator = ", ";
+            }
+            if(drift.change_point >= 0) report_stream() << separator << "shift of " << signed_percentage(drift.shift) << " from sample " << drift.change_point;
+            report_stream() << "\n";
+        }
+
+        static std::string signed_percentage(double d) {
+            return (d < 0 ? "-" : "+") + detail::percentage(std::abs(d));
+        }
 
         void print_environment_estimate(environment_estimate<fp_seconds> e, int iterations) {
             report_stream() << std::setprecision(7);
@@ -142,9 +299,14 @@ namespace nonius {
         }
 
         int n_samples = 0;
+        double target_rel_ci = 0;
         int n_resamples = 0;
         bool verbose = false;
+        bool reused_environment = false;
         bool summary = false;
+        bool cold = false;
+        bool single_runs = false;
+        fp_seconds resolution = fp_seconds::zero();
 
         std::string current;
     };
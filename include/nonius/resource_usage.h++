@@ -0,0 +1,86 @@
+// Nonius - C++ benchmarking tool
+//
+// Written in 2014- by the nonius contributors <nonius@rmf.io>
+//
+// To the extent possible under law, the author(s) have dedicated all copyright and related
+// and neighboring rights to this software to the public domain worldwide. This software is
+// distributed without any warranty.
+//
+// You should have received a copy of the CC0 Public Domain Dedication along with this software.
+// If not, see <http://creativecommons.org/publicdomain/zero/1.0/>
+
+// Resource usage
+
+#ifndef NONIUS_RESOURCE_USAGE_HPP
+#define NONIUS_RESOURCE_USAGE_HPP
+
+#include <nonius/clock.h++>
+
+#if defined(__unix__) || defined(__APPLE__)
+#   include <sys/resource.h>
+#   define NONIUS_HAS_GETRUSAGE
+#endif
+
+#include <cstdint>
+
+namespace nonius {
+    struct resource_usage {
+        fp_seconds user_time = fp_seconds::zero();
+        fp_seconds system_time = fp_seconds::zero();
+        std::int64_t max_rss_growth = 0; // bytes
+        std::int64_t minor_faults = 0;
+        std::int64_t major_faults = 0;
+        std::int64_t voluntary_context_switches = 0;
+        std::int64_t involuntary_context_switches = 0;
+    };
+
+    namespace detail {
+        inline bool resource_usage_available() {
+#ifdef NONIUS_HAS_GETRUSAGE
+            return true;
+#else
+            return false;
+#endif
+        }
+
+        inline resource_usage current_resource_usage() {
+            resource_usage r;
+#ifdef NONIUS_HAS_GETRUSAGE
+            rusage ru;
+#   ifdef RUSAGE_THREAD
+            int who = RUSAGE_THREAD;
+#   else
+            int who = RUSAGE_SELF;
+#   endif
+            if(getrusage(who, &ru) != 0) return r;
+            auto seconds = [](timeval tv) { return fp_seconds(tv.tv_sec + tv.tv_usec / 1e6); };
+            r.user_time = seconds(ru.ru_utime);
+            r.system_time = seconds(ru.ru_stime);
+#   ifdef __APPLE__
+            r.max_rss_growth = ru.ru_maxrss;
+#   else
+            r.max_rss_growth = static_cast<std::int64_t>(ru.ru_maxrss) * 1024;
+#   endif
+            r.minor_faults = ru.ru_minflt;
+            r.major_faults = ru.ru_majflt;
+            r.voluntary_context_switches = ru.ru_nvcsw;
+            r.involuntary_context_switches = ru.ru_nivcsw;
+#endif
+            return r;
+        }
+
+        inline resource_usage resource_usage_delta(resource_usage const& before, resource_usage const& after) {
+            resource_usage r;
+            r.user_time = after.user_time - before.user_time;
+            r.system_time = after.system_time - before.system_time;
+            r.max_rss_growth = after.max_rss_growth - before.max_rss_growth;
+            r.minor_faults = after.minor_faults - before.minor_faults;
+            r.major_faults = after.major_faults - before.major_faults;
+            r.voluntary_context_switches = after.voluntary_context_switches - before.voluntary_context_switches;
+            r.involuntary_context_switches = after.involuntary_context_switches - before.involuntary_context_switches;
+            return r;
+        }
+    } // namespace detail
+} // namespace nonius
+
+#endif // NONIUS_RESOURCE_USAGE_HPP
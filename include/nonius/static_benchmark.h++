@@ -0,0 +1,68 @@
+// Nonius - C++ benchmarking tool
+//
+// Written in 2014- by the nonius contributors <nonius@rmf.io>
+//
+// To the extent possible under law, the author(s) have dedicated all copyright and related
+// and neighboring rights to this software to the public domain worldwide. This software is
+// distributed without any warranty.
+//
+// You should have received a copy of the CC0 Public Domain Dedication along with this software.
+// If not, see <http://creativecommons.org/publicdomain/zero/1.0/>
+
+// Benchmarks timed without indirect calls
+
+#ifndef NONIUS_STATIC_BENCHMARK_HPP
+#define NONIUS_STATIC_BENCHMARK_HPP
+
+#include <nonius/benchmark.h++>
+#include <nonius/chronometer.h++>
+#include <nonius/clock.h++>
+#include <nonius/detail/meta.h++>
+
+#include <type_traits>
+#include <utility>
+
+namespace nonius {
+    namespace detail {
+        // Drives the runs on the concrete chronometer model, so that the timed region is a plain
+        // loop over the benchmark between two clock calls. Runs on any other clock go through the
+        // usual type-erased chronometer.
+        template <typename Clock, typename Fun>
+        struct static_benchmark_fn {
+            static_assert(!is_callable<Fun const&(chronometer)>::value, "static benchmarks take the run index or nothing");
+
+            void operator()(chronometer meter) const {
+                auto model = dynamic_cast<chronometer_model<Clock>*>(meter.impl);
+                if(model) {
+                    model->direct = true;
+                    run(*model, meter.runs(), is_callable<Fun const&(int)>());
+                } else {
+                    meter.measure(fun);
+                }
+            }
+
+            void run(chronometer_model<Clock>& model, int k, std::true_type) const {
+                model.start();
+                for(int i = 0; i < k; ++i) fun(i);
+                model.finish();
+            }
+            void run(chronometer_model<Clock>& model, int k, std::false_type) const {
+                model.start();
+                for(int i = 0; i < k; ++i) fun();
+                model.finish();
+            }
+
+            Fun fun;
+        };
+    } // namespace detail
+
+    template <typename Clock = default_clock, typename Fun>
+    detail::static_benchmark_fn<Clock, typename std::decay<Fun>::type> static_benchmark(Fun&& fun) {
+        return { std::forward<Fun>(fun) };
+    }
+} // namespace nonius
+
+#define NONIUS_STATIC_BENCHMARK(name, ...) \
+    NONIUS_BENCHMARK(name, ::nonius::static_benchmark(__VA_ARGS__))
+
+#endif // NONIUS_STATIC_BENCHMARK_HPP
@@ -0,0 +1,70 @@
+// Nonius - C++ benchmarking tool
+//
+// Written in 2014- by the nonius contributors <nonius@rmf.io>
+//
+// To the extent possible under law, the author(s) have dedicated all copyright and related
+// and neighboring rights to this software to the public domain worldwide. This software is
+// distributed without any warranty.
+//
+// You should have received a copy of the CC0 Public Domain Dedication along with this software.
+// If not, see <http://creativecommons.org/publicdomain/zero/1.0/>
+
+// Tests for adaptive sampling
+
+#include <nonius/execution_plan.h++>
+
+#include "manual_clock.h++"
+
+#include <catch.hpp>
+
+namespace nonius {
+
+namespace {
+
+execution_plan<FloatDuration<manual_clock>> make_plan(detail::benchmark_function fun) {
+    return { 1, FloatDuration<manual_clock>(0), {}, std::move(fun), FloatDuration<manual_clock>(0), 0 };
+}
+
+} // anon namespace
+
+TEST_CASE("running stats") {
+    detail::running_stats s;
+    for(double x : { 2., 4., 4., 4., 5., 5., 7., 9. }) s.add(x);
+
+    CHECK(s.count() == 8);
+    CHECK(s.mean() == Approx(5.));
+    CHECK(s.variance() == Approx(32. / 7.));
+    CHECK(s.relative_ci_half_width(0.95) == Approx(1.959964 * std::sqrt(32. / 7. / 8.) / 5.));
+}
+
+TEST_CASE("adaptive sampling") {
+    configuration cfg;
+    cfg.target_rel_ci = 0.01;
+    environment<FloatDuration<manual_clock>> env;
+    env.clock_cost.mean = FloatDuration<manual_clock>(0);
+    env.function_cost.mean = FloatDuration<manual_clock>(0);
+
+    SECTION("stable benchmarks stop after one batch") {
+        auto plan = make_plan([] { manual_clock::advance(100); });
+        auto samples = plan.collect<manual_clock>(cfg, env);
+        CHECK(samples.size() == static_cast<std::size_t>(detail::adaptive_batch_size));
+    }
+
+    SECTION("noisy benchmarks take more samples") {
+        int i = 0;
+        auto plan = make_plan([&i] { manual_clock::advance(++i % 2 == 0 ? 90 : 110); });
+        auto samples = plan.collect<manual_clock>(cfg, env);
+        CHECK(samples.size() > static_cast<std::size_t>(detail::adaptive_batch_size));
+        CHECK((samples.size() % detail::adaptive_batch_size) == 0);
+    }
+
+    SECTION("time cap") {
+        cfg.max_time = 1e-6;
+        int i = 0;
+        auto plan = make_plan([&i] { manual_clock::advance(++i % 2 == 0 ? 100 : 10000); });
+        auto samples = plan.collect<manual_clock>(cfg, env);
+        CHECK(samples.size() == static_cast<std::size_t>(detail::adaptive_batch_size));
+    }
+}
+
+} // namespace nonius
@@ -0,0 +1,112 @@
+// Nonius - C++ benchmarking tool
+//
+// Written in 2014- by the nonius contributors <nonius@rmf.io>
+//
+// To the extent possible under law, the author(s) have dedicated all copyright and related
+// and neighboring rights to this software to the public domain worldwide. This software is
+// distributed without any warranty.
+//
+// You should have received a copy of the CC0 Public Domain Dedication along with this software.
+// If not, see <http://creativecommons.org/publicdomain/zero/1.0/>
+
+// Tests for allocation tracking
+//
+// Tracking replaces the global operator new, so these run in their own executable, built with
+// NONIUS_TEST_ALLOCATIONS defined; in the main test runner only the disabled case is tested.
+
+#ifdef NONIUS_TEST_ALLOCATIONS
+#define NONIUS_TRACK_ALLOCATIONS
+#endif
+#include <nonius/allocation.h++>
+#include <nonius/optimizer.h++>
+
+#include "manual_clock.h++"
+
+#include <catch.hpp>
+
+#include <memory>
+#include <vector>
+
+namespace nonius {
+
+#ifdef NONIUS_TEST_ALLOCATIONS
+
+TEST_CASE("allocation tracking") {
+    REQUIRE(detail::allocation_tracking_enabled());
+
+    SECTION("only the timed region is counted") {
+        detail::reset_allocation_counters();
+        auto outside = std::unique_ptr<int>(new int(17));
+        auto model = detail::chronometer_model<manual_clock>{};
+        chronometer{model, 4, {}}.measure([] {
+            std::vector<char> v(100);
+            keep_memory(v.data());
+            return v.size();
+        });
+        auto stats = detail::allocation_snapshot(4);
+
+        CHECK(stats.calls == 4);
+        CHECK(stats.bytes == 400);
+        CHECK(stats.peak_bytes == 100);
+        CHECK(stats.calls_per_iteration() == 1.);
+        CHECK(stats.bytes_per_iteration() == 100.);
+    }
+
+    SECTION("peak is the highest growth in live bytes") {
+        detail::reset_allocation_counters();
+        auto model = detail::chronometer_model<manual_clock>{};
+        std::vector<std::unique_ptr<char[]>> kept;
+        kept.reserve(3);
+        chronometer{model, 3, {}}.measure([&] {
+            kept.emplace_back(new char[64]);
+        });
+        kept.clear();
+        auto stats = detail::allocation_snapshot(3);
+
+        CHECK(stats.calls == 3);
+        CHECK(stats.bytes == 3 * 64);
+        CHECK(stats.peak_bytes == 3 * 64);
+    }
+}
+
+TEST_CASE("allocation free benchmarks") {
+    auto model = detail::chronometer_model<manual_clock>{};
+    auto meter = chronometer{model, 8, {}};
+
+    SECTION("no allocations") {
+        int x = 0;
+        auto fn = allocation_free([&] { ++x; });
+        CHECK_NOTHROW(fn(meter));
+        CHECK(x == 8);
+    }
+
+    SECTION("allocations") {
+        auto fn = allocation_free([] {
+            auto p = std::unique_ptr<int>(new int(42));
+            keep_memory(p.get());
+        });
+        CHECK_THROWS_AS(fn(meter), allocation_error const&);
+    }
+
+    SECTION("with chronometer") {
+        auto fn = allocation_free([](chronometer meter) {
+            std::vector<int> setup(100);
+            meter.measure([&](int i) { return setup[i]; });
+        });
+        CHECK_NOTHROW(fn(meter));
+    }
+}
+
+#else
+
+TEST_CASE("allocation tracking disabled") {
+    auto model = detail::chronometer_model<manual_clock>{};
+    auto meter = chronometer{model, 8, {}};
+
+    CHECK_FALSE(detail::allocation_tracking_enabled());
+    CHECK_THROWS_AS(allocation_free([] {})(meter), allocation_tracking_disabled const&);
+}
+
+#endif // NONIUS_TEST_ALLOCATIONS
+
+} // namespace nonius
@@ -0,0 +1,136 @@
+// Nonius - C++ benchmarking tool
+//
+// Written in 2014- by the nonius contributors <nonius@rmf.io>
+//
+// To the extent possible under law, the author(s) have dedicated all copyright and related
+// and neighboring rights to this software to the public domain worldwide. This software is
+// distributed without any warranty.
+//
+// You should have received a copy of the CC0 Public Domain Dedication along with this software.
+// If not, see <http://creativecommons.org/publicdomain/zero/1.0/>
+
+// Tests for binary result files
+
+#include <nonius/binary_results.h++>
+#include <nonius/reporters/binary_reporter.h++>
+
+#include <catch.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace nonius {
+
+namespace {
+
+void write_results(std::string const& file) {
+    configuration cfg;
+    cfg.output_file = file;
+    binary_reporter rep;
+    rep.configure(cfg);
+    for(int size : { 2, 1 }) {
+        rep.params_start({ { "size", param(size) } });
+        for(auto name : { "zeta", "alpha" }) {
+            rep.benchmark_start(name);
+            rep.measurement_start(execution_plan<fp_seconds> { 10 * size, fp_seconds(1), {}, {}, fp_seconds(0), 0 });
+            rep.measurement_complete({ fp_seconds(size * 1.), fp_seconds(size * 2.), fp_seconds(size * 3.) });
+            rep.benchmark_complete();
+        }
+        rep.params_complete();
+    }
+    rep.params_start({});
+    rep.benchmark_start("broken");
+    rep.benchmark_failure(std::make_exception_ptr(std::runtime_error("oops")));
+    rep.params_complete();
+    rep.suite_complete();
+}
+
+} // anon namespace
+
+TEST_CASE("binary results") {
+    std::string file = "nonius-test-results.bin";
+    write_results(file);
+
+    SECTION("records are sorted by name and parameters") {
+        binary_results results(file);
+        REQUIRE(results.size() == 5);
+        CHECK(results[0].name() == "alpha");
+        CHECK(results[0].params() == "size=1");
+        CHECK(results[1].params() == "size=2");
+        CHECK(results[2].name() == "broken");
+        CHECK(results[3].name() == "zeta");
+    }
+
+    SECTION("samples are read in place") {
+        binary_results results(file);
+        auto r = results.find("zeta", { { "size", param(2) } });
+        REQUIRE(r);
+        auto address = reinterpret_cast<std::uintptr_t>(r.samples_begin());
+        CHECK((address % alignof(double)) == 0);
+        CHECK(std::vector<double>(r.samples_begin(), r.samples_end()) == (std::vector<double> { 2., 4., 6. }));
+        CHECK(r.iterations() == 20);
+        CHECK_FALSE(r.analysed());
+        CHECK_FALSE(results.find("zeta", { { "size", param(3) } }));
+        CHECK(results.find("alpha").size() == 2);
+    }
+
+    SECTION("failures are kept") {
+        binary_results results(file);
+        auto r = results.find("broken", {});
+        REQUIRE(r);
+        CHECK(r.failed());
+        CHECK(r.failure() == "oops");
+        CHECK(r.sample_count() == 0);
+    }
+
+    SECTION("incomplete files are rejected") {
+        std::ifstream in(file, std::ios::binary);
+        std::string contents((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        std::ofstream(file, std::ios::binary) << contents.substr(0, contents.size() - 8);
+        CHECK_THROWS_AS(binary_results { file }, binary_results_error const&);
+    }
+
+    std::remove(file.c_str());
+}
+
+TEST_CASE("binary results with long columns") {
+    std::string file = "nonius-test-long.bin";
+    std::vector<fp_seconds> samples(1000, fp_seconds(0.5));
+    {
+        configuration cfg;
+        cfg.output_file = file;
+        binary_reporter rep;
+        rep.configure(cfg);
+        rep.params_start({});
+        rep.benchmark_start("long");
+        rep.measurement_complete(samples);
+        rep.benchmark_complete();
+        rep.params_complete();
+        rep.suite_complete();
+    }
+
+    {
+        binary_results results(file);
+        auto r = results.find("long", {});
+        REQUIRE(r);
+#ifdef NONIUS_USE_ZLIB
+        CHECK(r.compressed());
+#else
+        CHECK_FALSE(r.compressed());
+#endif
+        CHECK(std::vector<double>(r.samples_begin(), r.samples_end()) == std::vector<double>(1000, 0.5));
+    }
+    std::remove(file.c_str());
+}
+
+TEST_CASE("binary results need an output file") {
+    configuration cfg;
+    binary_reporter rep;
+    CHECK_THROWS_AS(rep.configure(cfg), binary_on_console const&);
+}
+
+} // namespace nonius
@@ -0,0 +1,45 @@
+// Nonius - C++ benchmarking tool
+//
+// Written in 2014- by the nonius contributors <nonius@rmf.io>
+//
+// To the extent possible under law, the author(s) have dedicated all copyright and related
+// and neighboring rights to this software to the public domain worldwide. This software is
+// distributed without any warranty.
+//
+// You should have received a copy of the CC0 Public Domain Dedication along with this software.
+// If not, see <http://creativecommons.org/publicdomain/zero/1.0/>
+
+// Tests for data cache eviction
+
+#include <nonius/detail/cache_flush.h++>
+
+#include <catch.hpp>
+
+TEST_CASE("parse cache size") {
+    CHECK(nonius::detail::parse_cache_size("48K") == 48 * 1024);
+    CHECK(nonius::detail::parse_cache_size("1280K") == 1280 * 1024);
+    CHECK(nonius::detail::parse_cache_size("32M") == 32 * 1024 * 1024);
+    CHECK(nonius::detail::parse_cache_size("512") == 512);
+    CHECK(nonius::detail::parse_cache_size("") == 0);
+}
+
+TEST_CASE("eviction buffer size") {
+    auto largest = nonius::detail::largest_data_cache_size();
+    auto size = nonius::detail::eviction_buffer_size();
+    if(largest > 0) {
+        CHECK(size == 2 * largest);
+    } else {
+        CHECK(size == nonius::detail::default_eviction_size);
+    }
+}
+
+TEST_CASE("cache flusher touches every line") {
+    nonius::detail::cache_flusher flush(4096);
+    flush();
+    flush();
+    int wrong = 0;
+    for(std::size_t i = 0; i < flush.buffer.size(); ++i) {
+        if(flush.buffer[i] != (i % nonius::detail::cache_line_size == 0 ? 2 : 0)) ++wrong;
+    }
+    CHECK(wrong == 0);
+}
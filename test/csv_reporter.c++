@@ -0,0 +1,92 @@
+// Nonius - C++ benchmarking tool
+//
+// Written in 2014- by the nonius contributors <nonius@rmf.io>
+//
+// To the extent possible under law, the author(s) have dedicated all copyright and related
+// and neighboring rights to this software to the public domain worldwide. This software is
+// distributed without any warranty.
+//
+// You should have received a copy of the CC0 Public Domain Dedication along with this software.
+// If not, see <http://creativecommons.org/publicdomain/zero/1.0/>
+
+// Tests for the CSV reporter
+
+#include <nonius/reporters/csv_reporter.h++>
+
+#include <catch.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace nonius {
+
+namespace {
+
+std::string formatted(double x) {
+    char digits[detail::format_number_size];
+    return std::string(digits, detail::format_number(x, digits));
+}
+
+} // anon namespace
+
+TEST_CASE("number formatting") {
+    CHECK(formatted(0) == "0");
+    CHECK(formatted(0.5) == "0.5");
+    CHECK(formatted(-2.5) == "-2.5");
+    CHECK(formatted(100) == "100");
+    CHECK(formatted(0.0001) == "0.0001");
+    CHECK(formatted(1e-5) == "1e-05");
+    CHECK(formatted(6.76699e-10) == "6.76699e-10");
+    CHECK(formatted(1. / 3) == "0.333333333333333");
+    CHECK(formatted(999999999999999.9) == "1e+15");
+    CHECK(formatted(1.5e-300) == "1.5e-300");
+
+    for(double x = 1.234567e-9; x < 1e3; x *= 3.7) {
+        char expected[detail::format_number_size];
+        std::snprintf(expected, sizeof(expected), "%.15g", x);
+        CHECK(formatted(x) == expected);
+    }
+}
+
+TEST_CASE("csv rows") {
+    std::string file = "nonius-test-samples.csv";
+    configuration cfg;
+    cfg.output_file = file;
+    cfg.frequency = true;
+    {
+        csv_reporter rep;
+        rep.configure(cfg);
+        rep.params_start({ { "size", param(8) }, { "name", param(std::string("a \"b\"")) } });
+        rep.benchmark_start("first");
+        rep.measurement_complete({ fp_seconds(0.5), fp_seconds(0.25) });
+        frequency_analysis frequency;
+        frequency.cycles = { 10., 20. };
+        rep.frequency_complete(frequency);
+        sample_analysis<fp_seconds> analysis;
+        analysis.mean = { fp_seconds(0.375), fp_seconds(0.25), fp_seconds(0.5), 0.95 };
+        analysis.standard_deviation = { fp_seconds(0.125), fp_seconds(0), fp_seconds(0), 0.95 };
+        rep.analysis_complete(analysis);
+        rep.benchmark_complete();
+        rep.benchmark_start("second");
+        rep.measurement_complete({ fp_seconds(1e-9) });
+        rep.benchmark_complete();
+        rep.params_complete();
+    }
+
+    std::ifstream in(file);
+    std::vector<std::string> lines;
+    for(std::string line; std::getline(in, line);) lines.push_back(line);
+    std::remove(file.c_str());
+
+    CHECK(lines == (std::vector<std::string> {
+        "\"benchmark\",\"name\",\"size\",\"sample\",\"seconds\",\"cycles\",\"mean\",\"mean_lower_bound\",\"mean_upper_bound\",\"standard_deviation\"",
+        "\"first\",\"a \"\"b\"\"\",\"8\",0,0.5,10,0.375,0.25,0.5,0.125",
+        "\"first\",\"a \"\"b\"\"\",\"8\",1,0.25,20,0.375,0.25,0.5,0.125",
+        "\"second\",\"a \"\"b\"\"\",\"8\",0,1e-09,,,,,",
+    }));
+}
+
+} // namespace nonius
@@ -0,0 +1,95 @@
+// Nonius - C++ benchmarking tool
+//
+// Written in 2014- by the nonius contributors <nonius@rmf.io>
+//
+// To the extent possible under law, the author(s) have dedicated all copyright and related
+// and neighboring rights to this software to the public domain worldwide. This software is
+// distributed without any warranty.
+//
+// You should have received a copy of the CC0 Public Domain Dedication along with this software.
+// If not, see <http://creativecommons.org/publicdomain/zero/1.0/>
+
+// Tests for drift analysis
+
+#include <nonius/detail/drift.h++>
+#include <nonius/execution_plan.h++>
+
+#include "manual_clock.h++"
+
+#include <catch.hpp>
+
+#include <random>
+#include <vector>
+
+namespace nonius {
+
+namespace {
+
+std::vector<fp_seconds> every_millisecond(int n) {
+    std::vector<fp_seconds> starts;
+    for(int i = 0; i < n; ++i) starts.push_back(fp_seconds(i * 1e-3));
+    return starts;
+}
+
+std::vector<fp_seconds> noisy(int n, double mean, double (*drift)(int)) {
+    std::mt19937 rng(42);
+    std::normal_distribution<double> noise(0., mean * 0.01);
+    std::vector<fp_seconds> samples;
+    for(int i = 0; i < n; ++i) samples.push_back(fp_seconds(mean * (1 + drift(i)) + noise(rng)));
+    return samples;
+}
+
+} // anon namespace
+
+TEST_CASE("drift analysis") {
+    auto starts = every_millisecond(100);
+
+    SECTION("noise is stationary") {
+        auto drift = detail::analyse_drift(starts, noisy(100, 1e-6, [](int) { return 0.; }));
+        CHECK(drift.stationary);
+        CHECK(drift.trend_p > 0.01);
+    }
+
+    SECTION("gradual slowdown") {
+        auto drift = detail::analyse_drift(starts, noisy(100, 1e-6, [](int i) { return i * 0.001; }));
+        CHECK_FALSE(drift.stationary);
+        CHECK(drift.trend_z > 0);
+        CHECK(drift.trend_p < 0.01);
+        CHECK(drift.trend == Approx(0.099).epsilon(0.2));
+    }
+
+    SECTION("throttling halfway through") {
+        auto drift = detail::analyse_drift(starts, noisy(100, 1e-6, [](int i) { return i < 60 ? 0. : 0.2; }));
+        CHECK_FALSE(drift.stationary);
+        CHECK(drift.change_point == 60);
+        CHECK(drift.shift == Approx(0.2).epsilon(0.1));
+    }
+
+    SECTION("small effects are ignored") {
+        auto drift = detail::analyse_drift(starts, noisy(100, 1e-6, [](int i) { return i < 50 ? 0. : 0.01; }));
+        CHECK(drift.stationary);
+    }
+
+    SECTION("too few samples") {
+        auto drift = detail::analyse_drift(every_millisecond(5), noisy(5, 1e-6, [](int i) { return i * 0.5; }));
+        CHECK(drift.stationary);
+        CHECK(drift.change_point == -1);
+    }
+}
+
+TEST_CASE("sample start times") {
+    configuration cfg;
+    cfg.samples = 4;
+    environment<FloatDuration<manual_clock>> env;
+    env.clock_cost.mean = FloatDuration<manual_clock>(0);
+    env.function_cost.mean = FloatDuration<manual_clock>(0);
+    execution_plan<FloatDuration<manual_clock>> plan { 1, FloatDuration<manual_clock>(0), {}, [] { manual_clock::advance(100); }, FloatDuration<manual_clock>(0), 0 };
+
+    std::vector<fp_seconds> starts;
+    plan.collect<manual_clock>(cfg, env, &starts);
+    REQUIRE(starts.size() == 4);
+    CHECK(starts[0].count() == 0.);
+    CHECK(starts[3].count() == Approx(300e-9));
+}
+
+} // namespace nonius
@@ -0,0 +1,127 @@
+// Nonius - C++ benchmarking tool
+//
+// Written in 2014- by the nonius contributors <nonius@rmf.io>
+//
+// To the extent possible under law, the author(s) have dedicated all copyright and related
+// and neighboring rights to this software to the public domain worldwide. This software is
+// distributed without any warranty.
+//
+// You should have received a copy of the CC0 Public Domain Dedication along with this software.
+// If not, see <http://creativecommons.org/publicdomain/zero/1.0/>
+
+// Tests for the environment cache
+
+#include <nonius/detail/environment_cache.h++>
+#include <nonius/go.h++>
+
+#include <catch.hpp>
+
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace nonius {
+
+TEST_CASE("environment cache") {
+    environment<fp_seconds> env;
+    env.clock_resolution.mean = fp_seconds(2e-8);
+    env.clock_resolution.outliers.samples_seen = 100;
+    env.clock_resolution.outliers.low_severe = 1;
+    env.clock_resolution.outliers.low_mild = 2;
+    env.clock_resolution.outliers.high_mild = 3;
+    env.clock_resolution.outliers.high_severe = 4;
+    env.clock_cost.mean = fp_seconds(1.5e-8);
+    env.clock_cost.outliers.samples_seen = 10;
+    env.clock_cost.outliers.high_severe = 1;
+    env.function_cost.mean = fp_seconds(3e-9);
+    env.function_cost.outliers.samples_seen = 50;
+    env.function_cost.outliers.high_mild = 2;
+    environment<fp_seconds> other {
+        { fp_seconds(1e-6), {} },
+        { fp_seconds(4e-8), {} },
+        { fp_seconds(0), {} },
+    };
+    environment<fp_seconds> found;
+
+    std::stringstream empty, cache;
+    detail::update_environment_cache(empty, cache, "host\t1", 1000., env);
+
+    SECTION("round trip") {
+        REQUIRE(detail::find_cached_environment(cache, "host\t1", 1010., 60., found));
+        CHECK(found.clock_resolution.mean.count() == 2e-8);
+        CHECK(found.clock_cost.mean.count() == 1.5e-8);
+        CHECK(found.function_cost.mean.count() == 3e-9);
+        CHECK(found.clock_resolution.outliers.samples_seen == 100);
+        CHECK(found.clock_resolution.outliers.low_severe == 1);
+        CHECK(found.clock_resolution.outliers.high_severe == 4);
+        CHECK(found.clock_cost.outliers.high_mild == 0);
+        CHECK(found.clock_cost.outliers.high_severe == 1);
+        CHECK(found.function_cost.outliers.high_mild == 2);
+    }
+
+    SECTION("other keys are not used") {
+        CHECK_FALSE(detail::find_cached_environment(cache, "host\t2", 1010., 60., found));
+    }
+
+    SECTION("expired entries are not used") {
+        CHECK_FALSE(detail::find_cached_environment(cache, "host\t1", 1061., 60., found));
+    }
+
+    SECTION("entries for other keys are kept on update") {
+        std::stringstream updated;
+        detail::update_environment_cache(cache, updated, "host\t2", 2000., other);
+        std::string saved = updated.str();
+
+        std::istringstream in1(saved);
+        REQUIRE(detail::find_cached_environment(in1, "host\t1", 1010., 60., found));
+        CHECK(found.clock_resolution.mean.count() == 2e-8);
+        std::istringstream in2(saved);
+        REQUIRE(detail::find_cached_environment(in2, "host\t2", 2010., 60., found));
+        CHECK(found.clock_resolution.mean.count() == 1e-6);
+    }
+
+    SECTION("the key names the clock") {
+        auto key = detail::environment_cache_key<default_clock>();
+        CHECK(key == detail::environment_cache_key<default_clock>());
+        CHECK(key != detail::environment_cache_key<std::chrono::system_clock>());
+    }
+}
+
+namespace {
+
+struct environment_reporter : reporter {
+    std::string description() override { return "records environment events"; }
+
+    void do_estimate_clock_resolution_start() override { events.push_back("resolution start"); }
+    void do_estimate_clock_resolution_complete(environment_estimate<fp_seconds>) override { events.push_back("resolution"); }
+    void do_estimate_clock_cost_start() override { events.push_back("clock cost start"); }
+    void do_estimate_clock_cost_complete(environment_estimate<fp_seconds>) override { events.push_back("clock cost"); }
+    void do_estimate_function_cost_start() override { events.push_back("function cost start"); }
+    void do_estimate_function_cost_complete(environment_estimate<fp_seconds>) override { events.push_back("function cost"); }
+    void do_environment_reused() override { events.push_back("reused"); }
+
+    std::vector<std::string> events;
+};
+
+} // anon namespace
+
+TEST_CASE("cached environment is reported as reused") {
+    configuration cfg;
+    cfg.env_cache = "nonius-test-env.txt";
+    environment<fp_seconds> env;
+    env.clock_resolution.mean = fp_seconds(2e-8);
+    env.clock_cost.mean = fp_seconds(1.5e-8);
+    env.function_cost.mean = fp_seconds(3e-9);
+    auto now = chrono::duration_cast<fp_seconds>(chrono::system_clock::now().time_since_epoch()).count();
+    detail::store_environment(cfg.env_cache, detail::environment_cache_key<default_clock>(), now, env);
+
+    environment_reporter rep;
+    auto found = detail::measure_environment<default_clock>(cfg, rep);
+    CHECK(chrono::duration_cast<fp_seconds>(found.clock_resolution.mean).count() == Approx(2e-8));
+    CHECK(rep.events == (std::vector<std::string> { "reused", "resolution", "clock cost", "function cost" }));
+
+    std::remove(cfg.env_cache.c_str());
+}
+
+} // namespace nonius
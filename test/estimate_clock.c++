@@ -54,3 +54,16 @@ TEST_CASE("estimate_clock_resolution") {
     REQUIRE(res.outliers.total() == 0);
 }
 
+
+TEST_CASE("estimate_function_cost") {
+    auto rate = 1000;
+    nonius::counting_clock::set_rate(rate);
+    using duration = nonius::FloatDuration<nonius::counting_clock>;
+
+    auto cost = nonius::detail::estimate_function_cost<nonius::counting_clock>(duration(0));
+    REQUIRE(cost.mean.count() == rate);
+    REQUIRE(cost.outliers.samples_seen > 0);
+
+    auto without_clock = nonius::detail::estimate_function_cost<nonius::counting_clock>(duration(rate));
+    REQUIRE(without_clock.mean.count() == 0);
+}
@@ -24,7 +24,8 @@ TEST_CASE("faster than clock") {
     cfg.samples = 3;
     nonius::environment<nonius::FloatDuration<nonius::counting_clock>> env;
     env.clock_cost.mean = nonius::counting_clock::duration(1000);
-    nonius::execution_plan<nonius::counting_clock::duration> plan;
+    env.function_cost.mean = nonius::counting_clock::duration(0);
+    nonius::execution_plan<nonius::counting_clock::duration> plan {};
     plan.iterations_per_sample = 2;
     plan.benchmark = [] {
         nonius::counting_clock::set_rate(100);
@@ -0,0 +1,49 @@
+// Nonius - C++ benchmarking tool
+//
+// Written in 2014- by the nonius contributors <nonius@rmf.io>
+//
+// To the extent possible under law, the author(s) have dedicated all copyright and related
+// and neighboring rights to this software to the public domain worldwide. This software is
+// distributed without any warranty.
+//
+// You should have received a copy of the CC0 Public Domain Dedication along with this software.
+// If not, see <http://creativecommons.org/publicdomain/zero/1.0/>
+
+// Tests for timing the first calls of a benchmark
+
+#include <nonius/benchmark.h++>
+
+#include "manual_clock.h++"
+
+#include <catch.hpp>
+
+namespace nonius {
+
+TEST_CASE("first calls") {
+    configuration cfg;
+    cfg.first_calls = 3;
+    environment<FloatDuration<manual_clock>> env;
+    env.clock_cost.mean = FloatDuration<manual_clock>(5);
+    env.function_cost.mean = FloatDuration<manual_clock>(0);
+
+    SECTION("each call is timed on its own") {
+        int calls = 0;
+        benchmark b("slowing down", [&] { manual_clock::advance(100 * ++calls); });
+        auto times = b.first_calls<manual_clock>(cfg, {}, env);
+
+        REQUIRE(times.size() == 3);
+        CHECK(times[0].count() == 95.);
+        CHECK(times[1].count() == 195.);
+        CHECK(times[2].count() == 295.);
+    }
+
+    SECTION("clock cost never makes times negative") {
+        benchmark b("nothing", [] {});
+        auto times = b.first_calls<manual_clock>(cfg, {}, env);
+
+        REQUIRE(times.size() == 3);
+        for(auto t : times) CHECK(t.count() == 0.);
+    }
+}
+
+} // namespace nonius
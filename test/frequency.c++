@@ -0,0 +1,76 @@
+// Nonius - C++ benchmarking tool
+//
+// Written in 2014- by the nonius contributors <nonius@rmf.io>
+//
+// To the extent possible under law, the author(s) have dedicated all copyright and related
+// and neighboring rights to this software to the public domain worldwide. This software is
+// distributed without any warranty.
+//
+// You should have received a copy of the CC0 Public Domain Dedication along with this software.
+// If not, see <http://creativecommons.org/publicdomain/zero/1.0/>
+
+// Tests for effective frequency measurement
+
+#include <nonius/detail/frequency.h++>
+#include <nonius/execution_plan.h++>
+
+#include "manual_clock.h++"
+
+#include <catch.hpp>
+
+#include <vector>
+
+namespace nonius {
+
+TEST_CASE("frequency analysis") {
+    std::vector<fp_seconds> samples(4, fp_seconds(100e-9));
+    detail::frequency_readings readings;
+    readings.frequencies = { 3e9, 3e9, 2e9, 3.1e9 };
+
+    SECTION("cycles follow the frequency") {
+        auto analysis = detail::analyse_frequency(readings, samples);
+        REQUIRE(analysis.cycles.size() == 4);
+        CHECK(analysis.cycles[0] == Approx(300));
+        CHECK(analysis.cycles[2] == Approx(200));
+        CHECK(analysis.normalized.empty());
+    }
+
+    SECTION("samples slower than the median are degraded") {
+        auto analysis = detail::analyse_frequency(readings, samples);
+        CHECK(analysis.degraded == (std::vector<bool> { false, false, true, false }));
+    }
+
+    SECTION("normalized to the nominal frequency") {
+        readings.nominal = 2e9;
+        auto analysis = detail::analyse_frequency(readings, samples);
+        REQUIRE(analysis.normalized.size() == 4);
+        CHECK(analysis.normalized[0].count() == Approx(150e-9));
+        CHECK(analysis.normalized[2].count() == Approx(100e-9));
+    }
+
+    SECTION("mismatched readings") {
+        readings.frequencies.pop_back();
+        auto analysis = detail::analyse_frequency(readings, samples);
+        CHECK(analysis.cycles.empty());
+        CHECK(analysis.degraded.empty());
+    }
+}
+
+TEST_CASE("frequency meter") {
+    configuration cfg;
+    cfg.samples = 5;
+    environment<FloatDuration<manual_clock>> env;
+    env.clock_cost.mean = FloatDuration<manual_clock>(0);
+    env.function_cost.mean = FloatDuration<manual_clock>(0);
+    execution_plan<FloatDuration<manual_clock>> plan { 1, FloatDuration<manual_clock>(0), {}, [] { manual_clock::advance(100); }, FloatDuration<manual_clock>(0), 0 };
+
+    detail::frequency_meter<manual_clock> meter;
+    plan.collect<manual_clock>(cfg, env, nullptr, &meter);
+    CHECK(meter.readings().frequencies.size() == 5);
+
+#ifdef NONIUS_HAS_SPIN_LOOP
+    CHECK(detail::spin_frequency<default_clock>() > 0);
+#endif
+}
+
+} // namespace nonius
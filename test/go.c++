@@ -2,8 +2,14 @@
 // Tests for parameter related stuff
 
 #include <nonius/go.h++>
+
+#include "recording_reporter.h++"
+
 #include <catch.hpp>
 
+#include <string>
+#include <vector>
+
 namespace nonius {
 
 namespace {
@@ -95,4 +101,46 @@ TEST_CASE("generate params") {
     }
 }
 
+TEST_CASE("incompatible configurations") {
+    configuration cfg;
+    std::vector<benchmark> benchmarks { { "a", [](chronometer meter) { meter.measure([] { return std::string(10, 'x'); }); } } };
+    recording_reporter rep;
+    auto rejection = [&]() -> std::string {
+        try {
+            go(cfg, benchmarks.begin(), benchmarks.end(), rep);
+        } catch(incompatible_configuration const& e) {
+            return e.what();
+        }
+        return "";
+    };
+
+    SECTION("isolation and interleaving") {
+        cfg.isolate = true;
+        cfg.interleave = true;
+        CHECK(rejection() == "isolated benchmarks cannot be interleaved");
+    }
+    SECTION("isolation and a time budget") {
+        cfg.isolate = true;
+        cfg.time_budget = fp_seconds(1);
+        CHECK(rejection() == "a time budget cannot be combined with isolation");
+    }
+    SECTION("parallel jobs and interleaving") {
+        cfg.jobs = 2;
+        cfg.interleave = true;
+        CHECK(rejection() == "parallel jobs cannot be interleaved");
+    }
+    SECTION("parallel jobs and a time budget") {
+        cfg.jobs = 2;
+        cfg.time_budget = fp_seconds(1);
+        CHECK(rejection() == "a time budget cannot be combined with parallel jobs");
+    }
+    SECTION("sharding and a time budget") {
+        cfg.shard.index = 1;
+        cfg.shard.count = 2;
+        cfg.time_budget = fp_seconds(1);
+        CHECK(rejection() == "a time budget cannot be combined with sharding");
+    }
+    CHECK(rep.events.empty());
+}
+
 } // namespace nonius
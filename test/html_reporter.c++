@@ -0,0 +1,60 @@
+// Nonius - C++ benchmarking tool
+//
+// Written in 2014- by the nonius contributors <nonius@rmf.io>
+//
+// To the extent possible under law, the author(s) have dedicated all copyright and related
+// and neighboring rights to this software to the public domain worldwide. This software is
+// distributed without any warranty.
+//
+// You should have received a copy of the CC0 Public Domain Dedication along with this software.
+// If not, see <http://creativecommons.org/publicdomain/zero/1.0/>
+
+// Tests for the HTML reporter
+
+#include <nonius/reporters/html_reporter.h++>
+
+#include <catch.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+
+namespace nonius {
+
+TEST_CASE("html report") {
+    std::string file = "nonius-test-report.html";
+    configuration cfg;
+    cfg.output_file = file;
+    cfg.title = "</script>";
+    {
+        html_reporter rep;
+        rep.configure(cfg);
+        rep.params_start({ { "size", param(8) } });
+        rep.benchmark_start("fails");
+        rep.benchmark_failure(std::make_exception_ptr(std::runtime_error("oops")));
+        rep.benchmark_start("works");
+        rep.measurement_complete({ fp_seconds(2.5), fp_seconds(3.5) });
+        rep.benchmark_complete();
+        rep.params_complete();
+        rep.suite_complete();
+    }
+
+    std::ifstream in(file);
+    std::string report((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    std::remove(file.c_str());
+
+    CHECK(report.find("<title>&lt;/script&gt; - nonius report</title>") != std::string::npos);
+    CHECK(report.find("<option value=\"t0\">samples over time | size=8</option>") != std::string::npos);
+    CHECK(report.find("\"title\":\"\\u003c/script>\"") != std::string::npos);
+    CHECK(report.find("\"params\":{\"size\":\"8\"}") != std::string::npos);
+    CHECK(report.find("\"name\":\"works\",\"failed\":false") != std::string::npos);
+    CHECK(report.find("\"count\":2,\"startcount\":0") != std::string::npos);
+    CHECK(report.find("<script type=\"application/octet-stream\" id=\"samples0\">AAAgQAAAYEA=</script>") != std::string::npos); // float32 2.5, 3.5
+    CHECK(report.find("\"name\":\"fails\",\"failed\":true,\"mean\":0,\"stddev\":0,\"count\":0,\"startcount\":0") != std::string::npos);
+    CHECK(report.find("{$data}") == std::string::npos);
+    CHECK(report.find("{$samples}") == std::string::npos);
+}
+
+} // namespace nonius
@@ -0,0 +1,86 @@
+// Nonius - C++ benchmarking tool
+//
+// Written in 2014- by the nonius contributors <nonius@rmf.io>
+//
+// To the extent possible under law, the author(s) have dedicated all copyright and related
+// and neighboring rights to this software to the public domain worldwide. This software is
+// distributed without any warranty.
+//
+// You should have received a copy of the CC0 Public Domain Dedication along with this software.
+// If not, see <http://creativecommons.org/publicdomain/zero/1.0/>
+
+// Tests for interleaved sampling
+
+#include <nonius/go.h++>
+
+#include "recording_reporter.h++"
+
+#include <catch.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace nonius {
+
+TEST_CASE("interleaved sampling") {
+    configuration cfg;
+    cfg.samples = 20;
+    cfg.no_analysis = true;
+    cfg.interleave = true;
+    recording_reporter rep;
+    std::vector<char> log;
+
+    auto logging = [&log](char c) {
+        return [&log, c](chronometer meter) {
+            log.push_back(c);
+            meter.measure([] { return std::string(10, 'x'); });
+        };
+    };
+
+    SECTION("samples alternate between benchmarks") {
+        std::vector<benchmark> benchmarks { { "a", logging('a') }, { "b", logging('b') } };
+        detail::run_interleaved<default_clock>(cfg, fake_environment(), benchmarks, parameters{}, rep);
+
+        REQUIRE(log.size() >= 40);
+        auto sampling = std::vector<char>(log.end() - 40, log.end());
+        for(std::size_t i = 0; i < sampling.size(); i += 2) {
+            CHECK(sampling[i] != sampling[i + 1]);
+        }
+        CHECK(rep.events == (std::vector<std::string>{ "start a", "samples 20", "complete", "start b", "samples 20", "complete" }));
+    }
+
+    SECTION("failures are reported after the others are sampled") {
+        std::vector<benchmark> benchmarks {
+            { "a", logging('a') },
+            { "bad", [&log](chronometer meter) {
+                // "a" is only run again once sampling starts
+                auto sampling = std::find(std::find(log.begin(), log.end(), 'b'), log.end(), 'a') != log.end();
+                if(sampling) throw std::runtime_error("oops");
+                log.push_back('b');
+                meter.measure([] { return std::string(10, 'x'); });
+            } },
+        };
+        CHECK_THROWS_AS(detail::run_interleaved<default_clock>(cfg, fake_environment(), benchmarks, parameters{}, rep), benchmark_user_error const&);
+        CHECK(rep.events == (std::vector<std::string>{ "start a", "samples 20", "complete", "start bad", "failure" }));
+    }
+
+    SECTION("benchmarks left out of the time budget are skipped") {
+        cfg.time_budget = chrono::nanoseconds(1);
+        std::vector<benchmark> benchmarks { { "a", logging('a') }, { "b", logging('b') } };
+        auto planned = detail::plan_time_budget<default_clock>(cfg, fake_environment(), benchmarks, { parameters{} }, fp_seconds::zero(), rep);
+        detail::run_interleaved<default_clock>(cfg, fake_environment(), benchmarks, planned[0], rep);
+
+        CHECK(rep.events == (std::vector<std::string>{ "start a", "skipped", "start b", "skipped" }));
+    }
+
+    SECTION("adaptive sampling is rejected") {
+        cfg.target_rel_ci = 0.01;
+        std::vector<benchmark> benchmarks { { "a", logging('a') } };
+        CHECK_THROWS_AS(go(cfg, benchmarks.begin(), benchmarks.end(), rep), incompatible_configuration const&);
+        CHECK(rep.events.empty());
+    }
+}
+
+} // namespace nonius
@@ -0,0 +1,93 @@
+// Nonius - C++ benchmarking tool
+//
+// Written in 2014- by the nonius contributors <nonius@rmf.io>
+//
+// To the extent possible under law, the author(s) have dedicated all copyright and related
+// and neighboring rights to this software to the public domain worldwide. This software is
+// distributed without any warranty.
+//
+// You should have received a copy of the CC0 Public Domain Dedication along with this software.
+// If not, see <http://creativecommons.org/publicdomain/zero/1.0/>
+
+// Tests for running benchmarks in isolation
+
+#include <nonius/go.h++>
+
+#include "recording_reporter.h++"
+
+#include <catch.hpp>
+
+#include <csignal>
+#include <string>
+#include <vector>
+
+#ifdef NONIUS_HAS_FORK
+namespace nonius {
+
+TEST_CASE("pipe round trip") {
+    int fds[2];
+    REQUIRE(::pipe(fds) == 0);
+    detail::pipe_writer out { fds[1] };
+    out.put(42);
+    out.put(std::string("hello"));
+    out.put(std::vector<double>{ 1., 2., 3. });
+    ::close(fds[1]);
+
+    detail::pipe_reader in { fds[0] };
+    int i;
+    std::string s;
+    std::vector<double> v;
+    CHECK(in.get(i));
+    CHECK(in.get(s));
+    CHECK(in.get(v));
+    CHECK_FALSE(in.get(i));
+    ::close(fds[0]);
+
+    CHECK(i == 42);
+    CHECK(s == "hello");
+    CHECK(v == (std::vector<double>{ 1., 2., 3. }));
+}
+
+TEST_CASE("isolated benchmarks") {
+    configuration cfg;
+    cfg.samples = 5;
+    cfg.no_analysis = true;
+    auto env = fake_environment();
+    recording_reporter rep;
+
+    SECTION("results come back from the child") {
+        benchmark b("string", [] { return std::string(100, 'x'); });
+        CHECK(detail::run_isolated<default_clock>(cfg, env, b, {}, rep));
+        CHECK(rep.samples.size() == 5);
+        CHECK(rep.first_calls.empty());
+        CHECK(rep.failure.empty());
+    }
+
+    SECTION("first calls come back from the child") {
+        cfg.first_calls = 3;
+        int calls = 0;
+        benchmark b("count", [&] {
+            ++calls;
+            return std::string(100, 'x');
+        });
+        CHECK(detail::run_isolated<default_clock>(cfg, env, b, {}, rep));
+        CHECK(rep.first_calls.size() == 3);
+        CHECK(rep.samples.size() == 5);
+        CHECK(calls == 0); // all of it happened in the child
+    }
+
+    SECTION("exceptions become failures") {
+        benchmark b("throw", []() -> int { throw std::runtime_error("oops"); });
+        CHECK_FALSE(detail::run_isolated<default_clock>(cfg, env, b, {}, rep));
+        CHECK(rep.failure == "oops");
+    }
+
+    SECTION("crashes become failures") {
+        benchmark b("crash", [] { std::raise(SIGSEGV); });
+        CHECK_FALSE(detail::run_isolated<default_clock>(cfg, env, b, {}, rep));
+        CHECK(rep.failure.find("signal " + std::to_string(SIGSEGV)) != std::string::npos);
+    }
+}
+
+} // namespace nonius
+#endif // NONIUS_HAS_FORK
@@ -0,0 +1,71 @@
+// Nonius - C++ benchmarking tool
+//
+// Written in 2014- by the nonius contributors <nonius@rmf.io>
+//
+// To the extent possible under law, the author(s) have dedicated all copyright and related
+// and neighboring rights to this software to the public domain worldwide. This software is
+// distributed without any warranty.
+//
+// You should have received a copy of the CC0 Public Domain Dedication along with this software.
+// If not, see <http://creativecommons.org/publicdomain/zero/1.0/>
+
+// Tests for the JSON reporter
+
+#include <nonius/reporters/json_reporter.h++>
+
+#include <catch.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace nonius {
+
+TEST_CASE("json values") {
+    std::ostringstream os;
+    detail::write_json_string(os, "a \"b\"\\\n\x01");
+    os << ' ';
+    detail::write_json_number(os, 0.1);
+    os << ' ';
+    detail::write_json_number(os, 1. / 3);
+    os << ' ';
+    detail::write_json_number(os, std::numeric_limits<double>::infinity());
+    CHECK(os.str() == "\"a \\\"b\\\"\\\\\\n\\u0001\" 0.1 0.33333333333333331 null");
+}
+
+TEST_CASE("json events") {
+    std::string file = "nonius-test-events.ndjson";
+    configuration cfg;
+    cfg.output_file = file;
+    {
+        json_reporter rep;
+        rep.configure(cfg);
+        rep.environment_reused();
+        rep.params_start({ { "size", param(42) } });
+        rep.benchmark_start("tab\there");
+        rep.measurement_complete({ fp_seconds(0.5), fp_seconds(0.25) });
+        rep.sample_starts_complete({ fp_seconds(0), fp_seconds(0.75) });
+        rep.benchmark_failure(std::make_exception_ptr(std::runtime_error("oops")));
+        rep.params_complete();
+    }
+
+    std::ifstream in(file);
+    std::vector<std::string> lines;
+    for(std::string line; std::getline(in, line);) lines.push_back(line);
+    std::remove(file.c_str());
+
+    REQUIRE(lines.size() == 8);
+    CHECK(lines[1] == "{\"event\":\"environment_reused\"}");
+    CHECK(lines[2] == "{\"event\":\"params_start\",\"params\":{\"size\":\"42\"}}");
+    CHECK(lines[3] == "{\"event\":\"benchmark_start\",\"benchmark\":\"tab\\there\"}");
+    CHECK(lines[4] == "{\"event\":\"samples\",\"benchmark\":\"tab\\there\",\"samples\":[0.5,0.25]}");
+    CHECK(lines[5] == "{\"event\":\"sample_starts\",\"benchmark\":\"tab\\there\",\"starts\":[0,0.75]}");
+    CHECK(lines[6] == "{\"event\":\"failure\",\"benchmark\":\"tab\\there\",\"message\":\"oops\"}");
+    CHECK(lines[7] == "{\"event\":\"params_complete\"}");
+}
+
+} // namespace nonius
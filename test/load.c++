@@ -0,0 +1,160 @@
+// Nonius - C++ benchmarking tool
+//
+// Written in 2014- by the nonius contributors <nonius@rmf.io>
+//
+// To the extent possible under law, the author(s) have dedicated all copyright and related
+// and neighboring rights to this software to the public domain worldwide. This software is
+// distributed without any warranty.
+//
+// You should have received a copy of the CC0 Public Domain Dedication along with this software.
+// If not, see <http://creativecommons.org/publicdomain/zero/1.0/>
+
+// Tests for load generation
+
+#include <nonius/load.h++>
+
+#include "counting_clock.h++"
+
+#include <catch.hpp>
+
+#include <atomic>
+#include <stdexcept>
+
+namespace nonius {
+
+namespace {
+
+// Keeps the counting clock busy for the given time; each call to now() takes a microsecond.
+void busy(fp_seconds time) {
+    auto done = counting_clock::now() + chrono::duration_cast<counting_clock::duration>(time);
+    while(counting_clock::now() < done) {}
+}
+
+// Stands in for a server that handles one request at a time, each taking a fixed time.
+struct fake_server {
+    void operator()() { busy(service_time); }
+
+    fp_seconds service_time;
+};
+
+load_result fake_result(double target, double achieved, std::uint64_t p99_ns) {
+    load_result r { target, achieved, {} };
+    for(int i = 0; i < 100; ++i) r.latencies.record(std::uint64_t(1000));
+    r.latencies.record(p99_ns);
+    r.latencies.record(p99_ns);
+    return r;
+}
+
+} // anon namespace
+
+TEST_CASE("latency histogram") {
+    latency_histogram h;
+
+    SECTION("empty") {
+        CHECK(h.count() == 0);
+        CHECK(h.percentile(0.99).count() == 0.);
+    }
+
+    SECTION("percentiles are within 1%") {
+        for(std::uint64_t ns = 1; ns <= 100000; ++ns) h.record(ns * 1000);
+        CHECK(h.count() == 100000);
+        CHECK(h.percentile(0.5).count() == Approx(50e-3).epsilon(0.01));
+        CHECK(h.percentile(0.99).count() == Approx(99e-3).epsilon(0.01));
+        CHECK(h.percentile(1.).count() == Approx(100e-3));
+        CHECK(h.max().count() == Approx(100e-3));
+        CHECK(h.mean().count() == Approx(50.0005e-3));
+    }
+
+    SECTION("small values are exact") {
+        for(std::uint64_t ns = 0; ns < 100; ++ns) h.record(ns);
+        CHECK(h.percentile(0.5).count() == Approx(49e-9));
+    }
+
+    SECTION("buckets cover every value") {
+        for(int shift = 0; shift < 64; ++shift) {
+            auto v = std::uint64_t(1) << shift;
+            auto i = latency_histogram::index(v);
+            CHECK(latency_histogram::highest_in(i) >= v);
+            CHECK(latency_histogram::index(latency_histogram::highest_in(i)) == i);
+        }
+    }
+
+    SECTION("merge") {
+        latency_histogram other;
+        h.record(std::uint64_t(10));
+        other.record(std::uint64_t(30));
+        h.merge(other);
+        CHECK(h.count() == 2);
+        CHECK(h.max().count() == Approx(30e-9));
+    }
+}
+
+TEST_CASE("open-loop load") {
+    counting_clock::set_rate(1000);
+    load_configuration cfg;
+    cfg.rate = 2000.;
+    cfg.duration = fp_seconds(0.1);
+
+    SECTION("constant arrivals") {
+        int calls = 0;
+        auto r = run_load<counting_clock>(cfg, [&] { ++calls; });
+        CHECK(calls == 200);
+        CHECK(r.latencies.count() == 200);
+        CHECK(r.latencies.max().count() < 1e-5);
+        CHECK(r.achieved_rate == Approx(2000.));
+    }
+
+    SECTION("poisson arrivals from several threads") {
+        cfg.arrivals = arrival_process::poisson;
+        cfg.threads = 2;
+        std::atomic<int> calls { 0 };
+        // only the schedule decides how many operations are issued, not how fast they run
+        auto r = run_load(cfg, [&] { ++calls; });
+        CHECK(calls > 100);
+        CHECK(calls < 300);
+    }
+
+    SECTION("stalls delay every operation behind them") {
+        bool first = true;
+        auto r = run_load<counting_clock>(cfg, [&] {
+            if(first) busy(fp_seconds(20e-3));
+            first = false;
+        });
+        // the 40 operations due during the stall are delayed by up to 20ms
+        CHECK(r.latencies.count() == 200);
+        CHECK(r.latencies.max().count() == Approx(20e-3).epsilon(0.01));
+        CHECK(r.latencies.percentile(0.9).count() > 1e-3);
+        CHECK(r.latencies.percentile(0.75).count() < 1e-5);
+    }
+
+    SECTION("errors are passed on") {
+        CHECK_THROWS_AS(run_load<counting_clock>(cfg, [] { throw std::runtime_error("down"); }), std::runtime_error const&);
+    }
+}
+
+TEST_CASE("throughput knee") {
+    SECTION("against a server") {
+        counting_clock::set_rate(1000);
+        load_configuration cfg;
+        cfg.duration = fp_seconds(0.1);
+        fake_server server;
+        server.service_time = fp_seconds(1e-3);
+        auto sweep = sweep_load<counting_clock>(cfg, { 100., 400., 3000. }, server);
+        REQUIRE(sweep.size() == 3);
+        // one request per millisecond at most
+        CHECK(sweep[2].achieved_rate == Approx(1000.).epsilon(0.01));
+        CHECK(find_knee(sweep) == 1);
+    }
+
+    SECTION("latency growth") {
+        std::vector<load_result> sweep { fake_result(100, 100, 2000), fake_result(200, 200, 5000), fake_result(400, 400, 100000) };
+        CHECK(find_knee(sweep) == 1);
+    }
+
+    SECTION("saturated from the start") {
+        std::vector<load_result> sweep { fake_result(100, 50, 2000) };
+        CHECK(find_knee(sweep) == -1);
+    }
+}
+
+} // namespace nonius
@@ -0,0 +1,123 @@
+// Nonius - C++ benchmarking tool
+//
+// Written in 2014- by the nonius contributors <nonius@rmf.io>
+//
+// To the extent possible under law, the author(s) have dedicated all copyright and related
+// and neighboring rights to this software to the public domain worldwide. This software is
+// distributed without any warranty.
+//
+// You should have received a copy of the CC0 Public Domain Dedication along with this software.
+// If not, see <http://creativecommons.org/publicdomain/zero/1.0/>
+
+// Tests for asynchronous measurement
+
+#include <nonius/chronometer.h++>
+
+#include "manual_clock.h++"
+
+#include <catch.hpp>
+
+#include <algorithm>
+#include <deque>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace nonius {
+
+namespace {
+
+// Completes pending operations one at a time, each taking ten ticks.
+struct fake_event_loop {
+    void operator()() {
+        if(pending.empty()) return;
+        manual_clock::advance(10);
+        auto done = pending.front();
+        pending.pop_front();
+        done();
+    }
+
+    std::deque<completion> pending;
+};
+
+} // anon namespace
+
+TEST_CASE("asynchronous measurement") {
+    parameters params;
+    detail::chronometer_model<manual_clock> model;
+
+    SECTION("timing lasts until every run completed") {
+        fake_event_loop loop;
+        std::vector<int> started;
+        chronometer(model, 5, params).measure_async([&](int i, completion done) {
+            started.push_back(i);
+            loop.pending.push_back(done);
+        }, [&] { loop(); });
+        CHECK(started == (std::vector<int>{ 0, 1, 2, 3, 4 }));
+        CHECK(loop.pending.empty());
+        CHECK(model.elapsed().count() == 50);
+    }
+
+    SECTION("runs in flight can be bounded") {
+        fake_event_loop loop;
+        std::size_t most = 0;
+        chronometer(model, 10, params).measure_async([&](int, completion done) {
+            loop.pending.push_back(done);
+            most = std::max(most, loop.pending.size());
+        }, [&] { loop(); }, 3);
+        CHECK(most == 3);
+        CHECK(model.elapsed().count() == 100);
+    }
+
+    SECTION("completions from other threads") {
+        std::vector<std::thread> threads;
+        chronometer(model, 4, params).measure_async([&](int, completion done) {
+            threads.emplace_back([done] { done(); });
+        });
+        for(auto&& t : threads) t.join();
+        CHECK(threads.size() == 4);
+    }
+
+    SECTION("failed runs are rethrown once all completed") {
+        fake_event_loop loop;
+        auto meter = chronometer(model, 5, params);
+        CHECK_THROWS_AS(meter.measure_async([&](int i, completion done) {
+            if(i == 2) done.fail(std::make_exception_ptr(std::runtime_error("failed")));
+            else loop.pending.push_back(done);
+        }, [&] { loop(); }), std::runtime_error const&);
+        CHECK(loop.pending.empty());
+    }
+
+    SECTION("runs that throw wait for the ones already started") {
+        fake_event_loop loop;
+        auto meter = chronometer(model, 5, params);
+        CHECK_THROWS_AS(meter.measure_async([&](int i, completion done) {
+            if(i == 3) throw std::runtime_error("failed");
+            loop.pending.push_back(done);
+        }, [&] { loop(); }), std::runtime_error const&);
+        CHECK(loop.pending.empty());
+        CHECK(model.elapsed().count() == 30);
+    }
+
+#ifdef NONIUS_HAS_COROUTINES
+    SECTION("awaitables") {
+        std::deque<std::coroutine_handle<>> suspended;
+        struct tick {
+            std::deque<std::coroutine_handle<>>* queue;
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> h) const { queue->push_back(h); }
+            void await_resume() const noexcept {}
+        };
+        chronometer(model, 4, params).measure_async([&](int) { return tick{&suspended}; }, [&] {
+            manual_clock::advance(10);
+            auto h = suspended.front();
+            suspended.pop_front();
+            h.resume();
+        });
+        CHECK(suspended.empty());
+        CHECK(model.elapsed().count() == 40);
+    }
+#endif // NONIUS_HAS_COROUTINES
+}
+
+} // namespace nonius
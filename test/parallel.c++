@@ -0,0 +1,71 @@
+// Nonius - C++ benchmarking tool
+//
+// Written in 2014- by the nonius contributors <nonius@rmf.io>
+//
+// To the extent possible under law, the author(s) have dedicated all copyright and related
+// and neighboring rights to this software to the public domain worldwide. This software is
+// distributed without any warranty.
+//
+// You should have received a copy of the CC0 Public Domain Dedication along with this software.
+// If not, see <http://creativecommons.org/publicdomain/zero/1.0/>
+
+// Tests for running benchmarks in parallel
+
+#include <nonius/go.h++>
+
+#include "recording_reporter.h++"
+
+#include <catch.hpp>
+
+#include <csignal>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace nonius {
+
+TEST_CASE("cpu lists") {
+    CHECK(detail::parse_cpu_list("0-3,8,10-11") == (std::vector<int> { 0, 1, 2, 3, 8, 10, 11 }));
+    CHECK(detail::parse_cpu_list("5") == (std::vector<int> { 5 }));
+    CHECK(detail::parse_cpu_list("").empty());
+}
+
+TEST_CASE("job cpus") {
+    auto cpus = detail::job_cpus(4, false);
+    CHECK(cpus.size() <= 4);
+    CHECK(std::set<int>(cpus.begin(), cpus.end()).size() == cpus.size());
+    CHECK(detail::job_cpus(4, true).size() <= cpus.size());
+}
+
+TEST_CASE("interference checks are spread over the suite") {
+    CHECK(detail::interference_check_indices(0).empty());
+    CHECK(detail::interference_check_indices(2) == (std::vector<std::size_t> { 0, 1 }));
+    CHECK(detail::interference_check_indices(9) == (std::vector<std::size_t> { 0, 3, 6 }));
+}
+
+#ifdef NONIUS_HAS_FORK
+TEST_CASE("parallel benchmarks") {
+    configuration cfg;
+    cfg.samples = 3;
+    cfg.no_analysis = true;
+    cfg.jobs = 2;
+    auto env = fake_environment();
+
+    std::vector<benchmark> benchmarks {
+        benchmark("slow", [] { std::this_thread::sleep_for(chrono::milliseconds(1)); }),
+        benchmark("crash", [] { std::raise(SIGSEGV); }),
+        benchmark("fast", [] { return std::string(10, 'x'); }),
+    };
+    recording_reporter rep;
+    detail::run_parallel<default_clock>(cfg, env, benchmarks, {}, rep);
+
+    REQUIRE(rep.events.size() >= 8);
+    std::vector<std::string> reported(rep.events.begin(), rep.events.begin() + 8);
+    CHECK(reported == (std::vector<std::string> { "start slow", "samples 3", "complete", "start crash", "failure", "start fast", "samples 3", "complete" }));
+    for(auto i = rep.events.begin() + 8; i != rep.events.end(); ++i) {
+        CHECK((*i == "check slow" || *i == "check fast"));
+    }
+}
+#endif // NONIUS_HAS_FORK
+
+} // namespace nonius
@@ -0,0 +1,112 @@
+// Nonius - C++ benchmarking tool
+//
+// Written in 2014- by the nonius contributors <nonius@rmf.io>
+//
+// To the extent possible under law, the author(s) have dedicated all copyright and related
+// and neighboring rights to this software to the public domain worldwide. This software is
+// distributed without any warranty.
+//
+// You should have received a copy of the CC0 Public Domain Dedication along with this software.
+// If not, see <http://creativecommons.org/publicdomain/zero/1.0/>
+
+// Tests for the plan cache
+
+#include <nonius/detail/plan_cache.h++>
+
+#include <catch.hpp>
+
+#include <sstream>
+#include <string>
+
+namespace nonius {
+
+TEST_CASE("plan cache") {
+    parameters small { { "size", param(10) }, { "name", param(std::string("x")) } };
+    parameters large { { "size", param(1000) }, { "name", param(std::string("x")) } };
+
+    SECTION("parameters have a canonical key") {
+        CHECK(detail::params_key(small) == "name=x;size=10");
+        CHECK(detail::params_key({}) == "");
+    }
+
+    SECTION("entries are keyed by name and parameters") {
+        detail::plan_cache cache("build-1", false);
+        cache.insert("sort", small, { 100, fp_seconds(1e-6) });
+        cache.insert("sort", large, { 3, fp_seconds(1e-4) });
+
+        REQUIRE(cache.find("sort", small));
+        CHECK(cache.find("sort", small)->iterations == 100);
+        CHECK(cache.find("sort", large)->iterations == 3);
+        CHECK_FALSE(cache.find("find", small));
+    }
+
+    SECTION("round trip through a file") {
+        detail::plan_cache cache("build-1", false);
+        cache.insert("weird\tname\\", small, { 42, fp_seconds(2.5e-7) });
+        std::stringstream ss;
+        cache.save(ss);
+        ss << "garbage line\n";
+
+        detail::plan_cache loaded("build-1", false);
+        loaded.load(ss);
+        CHECK(loaded.size() == 1);
+        REQUIRE(loaded.find("weird\tname\\", small));
+        CHECK(loaded.find("weird\tname\\", small)->iterations == 42);
+        CHECK(loaded.find("weird\tname\\", small)->iteration_time.count() == 2.5e-7);
+    }
+
+    SECTION("other binaries are ignored unless pinned") {
+        detail::plan_cache old("build-1", false);
+        old.insert("sort", small, { 100, fp_seconds(1e-6) });
+        std::stringstream ss;
+        old.save(ss);
+        auto saved = ss.str();
+
+        detail::plan_cache fresh("build-2", false);
+        std::istringstream in1(saved);
+        fresh.load(in1);
+        CHECK_FALSE(fresh.find("sort", small));
+
+        detail::plan_cache pinned("build-2", true);
+        std::istringstream in2(saved);
+        pinned.load(in2);
+        REQUIRE(pinned.find("sort", small));
+        CHECK(pinned.find("sort", small)->iterations == 100);
+
+        pinned.insert("sort", small, { 7, fp_seconds(1e-6) });
+        CHECK(pinned.find("sort", small)->iterations == 100);
+    }
+
+    SECTION("old binaries are dropped on save unless pinned") {
+        std::stringstream ss;
+        ss << "build-1\tsort\tname=x;size=10\t100\t1e-06\n"
+           << "build-2\tsort\tname=x;size=10\t90\t1e-06\n"
+           << "build-1\tfind\tname=x;size=10\t50\t1e-06\n"
+           << "build-2\tfind\tname=x;size=10\t60\t1e-06\n";
+        auto saved = ss.str();
+
+        detail::plan_cache fresh("build-3", false);
+        std::istringstream in1(saved);
+        fresh.load(in1);
+        fresh.insert("sort", small, { 80, fp_seconds(1e-6) });
+        std::stringstream out1;
+        fresh.save(out1);
+
+        detail::plan_cache reloaded("build-3", false);
+        reloaded.load(out1);
+        CHECK(reloaded.size() == 2);
+        CHECK(reloaded.find("sort", small)->iterations == 80);
+        CHECK(reloaded.find_any("find", small)->iterations == 50);
+
+        detail::plan_cache pinned("build-3", true);
+        std::istringstream in2(saved);
+        pinned.load(in2);
+        std::stringstream out2;
+        pinned.save(out2);
+        detail::plan_cache kept("build-3", true);
+        kept.load(out2);
+        CHECK(kept.size() == 4);
+    }
+}
+
+} // namespace nonius
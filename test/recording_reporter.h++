@@ -0,0 +1,62 @@
+// Nonius - C++ benchmarking tool
+//
+// Written in 2014- by the nonius contributors <nonius@rmf.io>
+//
+// To the extent possible under law, the author(s) have dedicated all copyright and related
+// and neighboring rights to this software to the public domain worldwide. This software is
+// distributed without any warranty.
+//
+// You should have received a copy of the CC0 Public Domain Dedication along with this software.
+// If not, see <http://creativecommons.org/publicdomain/zero/1.0/>
+
+// Reporter that records what it is told, and an environment that corrects nothing
+
+#ifndef NONIUS_TEST_RECORDING_REPORTER_HPP
+#define NONIUS_TEST_RECORDING_REPORTER_HPP
+
+#include <nonius/clock.h++>
+#include <nonius/environment.h++>
+#include <nonius/reporter.h++>
+
+#include <exception>
+#include <string>
+#include <vector>
+
+namespace nonius {
+    struct recording_reporter : reporter {
+        std::string description() override { return "records events"; }
+
+        void do_benchmark_start(std::string const& name) override { events.push_back("start " + name); }
+        void do_first_calls_complete(std::vector<fp_seconds> const& t) override { first_calls = t; }
+        void do_measurement_complete(std::vector<fp_seconds> const& s) override {
+            samples = s;
+            events.push_back("samples " + std::to_string(s.size()));
+        }
+        void do_benchmark_failure(std::exception_ptr e) override {
+            events.push_back("failure");
+            try {
+                std::rethrow_exception(e);
+            } catch(std::exception const& ex) {
+                failure = ex.what();
+            } catch(...) {}
+        }
+        void do_benchmark_skipped() override { events.push_back("skipped"); }
+        void do_benchmark_complete() override { events.push_back("complete"); }
+        void do_interference_check_complete(interference_check const& check) override { events.push_back("check " + check.benchmark); }
+
+        std::vector<std::string> events;
+        std::vector<fp_seconds> first_calls;
+        std::vector<fp_seconds> samples; // of the last benchmark
+        std::string failure; // of the last failure
+    };
+
+    inline environment<FloatDuration<default_clock>> fake_environment() {
+        environment<FloatDuration<default_clock>> env;
+        env.clock_resolution.mean = chrono::nanoseconds(1);
+        env.clock_cost.mean = chrono::nanoseconds(0);
+        env.function_cost.mean = chrono::nanoseconds(0);
+        return env;
+    }
+} // namespace nonius
+
+#endif // NONIUS_TEST_RECORDING_REPORTER_HPP
@@ -0,0 +1,46 @@
+// Nonius - C++ benchmarking tool
+//
+// Written in 2014- by the nonius contributors <nonius@rmf.io>
+//
+// To the extent possible under law, the author(s) have dedicated all copyright and related
+// and neighboring rights to this software to the public domain worldwide. This software is
+// distributed without any warranty.
+//
+// You should have received a copy of the CC0 Public Domain Dedication along with this software.
+// If not, see <http://creativecommons.org/publicdomain/zero/1.0/>
+
+// Tests for resource usage collection
+
+#include <nonius/resource_usage.h++>
+
+#include <catch.hpp>
+
+TEST_CASE("resource usage delta") {
+    nonius::resource_usage before, after;
+    before.user_time = nonius::fp_seconds(1.);
+    after.user_time = nonius::fp_seconds(3.);
+    before.minor_faults = 10;
+    after.minor_faults = 15;
+    after.involuntary_context_switches = 2;
+
+    auto delta = nonius::detail::resource_usage_delta(before, after);
+
+    CHECK(delta.user_time.count() == 2.);
+    CHECK(delta.system_time.count() == 0.);
+    CHECK(delta.minor_faults == 5);
+    CHECK(delta.involuntary_context_switches == 2);
+}
+
+TEST_CASE("resource usage is monotonic") {
+    auto before = nonius::detail::current_resource_usage();
+    volatile double x = 0;
+    for(int i = 0; i < 1000000; ++i) x = x + i;
+    auto after = nonius::detail::current_resource_usage();
+
+    auto delta = nonius::detail::resource_usage_delta(before, after);
+
+    CHECK(delta.user_time.count() >= 0.);
+    CHECK(delta.system_time.count() >= 0.);
+    CHECK(delta.max_rss_growth >= 0);
+    CHECK(delta.minor_faults >= 0);
+}
@@ -0,0 +1,114 @@
+// Nonius - C++ benchmarking tool
+//
+// Written in 2014- by the nonius contributors <nonius@rmf.io>
+//
+// To the extent possible under law, the author(s) have dedicated all copyright and related
+// and neighboring rights to this software to the public domain worldwide. This software is
+// distributed without any warranty.
+//
+// You should have received a copy of the CC0 Public Domain Dedication along with this software.
+// If not, see <http://creativecommons.org/publicdomain/zero/1.0/>
+
+// Tests for measuring with per-iteration setup
+
+#include <nonius/chronometer.h++>
+
+#include "manual_clock.h++"
+
+#include <catch.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace nonius {
+
+namespace {
+
+struct counted {
+    explicit counted(int i) : value(i) { ++alive; }
+    counted(counted const& that) : value(that.value) { ++alive; }
+    ~counted() { --alive; }
+
+    int value;
+    static int alive;
+};
+int counted::alive = 0;
+
+} // anon namespace
+
+TEST_CASE("measure with setup") {
+    auto model = detail::chronometer_model<manual_clock>{};
+    auto meter = chronometer{model, 10, {}};
+
+    SECTION("only the body is timed") {
+        std::vector<int> seen;
+        meter.measure([](int i) {
+            manual_clock::advance(1000);
+            return i * 2;
+        }, [&](int& x) {
+            manual_clock::advance(1);
+            seen.push_back(x);
+        });
+
+        CHECK(model.elapsed().count() == 10);
+        CHECK(seen == (std::vector<int>{ 0, 2, 4, 6, 8, 10, 12, 14, 16, 18 }));
+    }
+
+    SECTION("setup without index") {
+        int calls = 0;
+        meter.measure([&] { return ++calls; }, [](int&) {});
+        CHECK(calls == 10);
+    }
+
+    SECTION("objects are destroyed") {
+        meter.measure([](int i) { return counted(i); }, [](counted& c) { CHECK(counted::alive > 0); (void)c; });
+        CHECK(counted::alive == 0);
+    }
+
+    SECTION("storage is cache aligned") {
+        std::uintptr_t first = 0;
+        meter.measure([](int i) { return i; }, [&](int& x) {
+            if(x == 0) first = reinterpret_cast<std::uintptr_t>(&x);
+        });
+        CHECK((first % detail::cache_line_size) == 0);
+    }
+
+    SECTION("large runs are split in chunks") {
+        using big = std::array<char, (4 << 20)>;
+        REQUIRE(detail::setup_batch_capacity(sizeof(big), 10) == 4);
+
+        int setups = 0;
+        int bodies = 0;
+        int max_ahead = 0;
+        meter.measure([&](int) {
+            ++setups;
+            return big{};
+        }, [&](big&) {
+            ++bodies;
+            max_ahead = std::max(max_ahead, setups - bodies + 1);
+            manual_clock::advance(1);
+        });
+
+        CHECK(setups == 10);
+        CHECK(bodies == 10);
+        CHECK(max_ahead == 4);
+        CHECK(model.elapsed().count() == 10);
+        CHECK(model.regions == 3);
+    }
+
+    SECTION("batch size bounds the inputs alive at once") {
+        REQUIRE(detail::setup_batch_capacity(sizeof(int), 10, 3) == 3);
+
+        int max_alive = 0;
+        meter.measure([](int i) { return counted(i); }, [&](counted&) {
+            max_alive = std::max(max_alive, counted::alive);
+        }, 3);
+
+        CHECK(max_alive == 3);
+        CHECK(model.regions == 4);
+    }
+}
+
+} // namespace nonius
@@ -0,0 +1,199 @@
+// Nonius - C++ benchmarking tool
+//
+// Written in 2014- by the nonius contributors <nonius@rmf.io>
+//
+// To the extent possible under law, the author(s) have dedicated all copyright and related
+// and neighboring rights to this software to the public domain worldwide. This software is
+// distributed without any warranty.
+//
+// You should have received a copy of the CC0 Public Domain Dedication along with this software.
+// If not, see <http://creativecommons.org/publicdomain/zero/1.0/>
+
+// Tests for sharding and merging
+
+#include <nonius/detail/shard.h++>
+#include <nonius/go.h++>
+#include <nonius/merge.h++>
+#include <nonius/reporters/raw_reporter.h++>
+
+#include <catch.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace nonius {
+
+TEST_CASE("longest processing time first") {
+    SECTION("balances the load") {
+        auto shards = detail::assign_shards({ 7., 5., 4., 3., 3., 2. }, 2);
+        CHECK(shards == (std::vector<int> { 1, 2, 2, 1, 2, 1 }));
+    }
+
+    SECTION("ties are broken by position") {
+        CHECK(detail::assign_shards({ 1., 1., 1., 1. }, 3) == (std::vector<int> { 1, 2, 3, 1 }));
+    }
+}
+
+TEST_CASE("shard planning") {
+    configuration cfg;
+    cfg.samples = 10;
+    cfg.shard.index = 2;
+    cfg.shard.count = 2;
+    std::vector<std::string> names { "a", "b", "c" };
+    std::vector<parameters> all_params(1);
+
+    SECTION("without estimates") {
+        auto plan = detail::plan_shards(cfg, names, all_params, nullptr);
+        CHECK(plan.assignment == (std::vector<int> { 1, 2, 1 }));
+        CHECK(plan.estimated == fp_seconds::zero());
+    }
+
+    SECTION("with estimates from any binary") {
+        detail::plan_cache plans("this binary", false);
+        std::istringstream cached("elsewhere\ta\t\t1\t0.1\nelsewhere\tc\t\t10\t0.5\n");
+        plans.load(cached);
+        auto plan = detail::plan_shards(cfg, names, all_params, &plans);
+        // a costs 1s, c costs 50s, and b as much as the average
+        CHECK(plan.assignment == (std::vector<int> { 2, 2, 1 }));
+        CHECK(plan.estimated.count() == Approx(26.5));
+    }
+}
+
+namespace {
+
+struct merged_reporter : reporter {
+    std::string description() override { return "records merged results"; }
+
+    void do_configure(configuration& cfg) override { resamples = cfg.resamples; }
+    void do_params_start(parameters const& params) override { this->params = params; }
+    void do_benchmark_start(std::string const& name) override { events.push_back(name); }
+    void do_measurement_complete(std::vector<fp_seconds> const& s) override { events.push_back("samples " + std::to_string(s.size())); }
+    void do_sample_starts_complete(std::vector<fp_seconds> const& s) override { events.push_back("starts " + std::to_string(s.size())); }
+    void do_resource_usage_complete(resource_usage const& usage) override { events.push_back("faults " + std::to_string(usage.minor_faults)); }
+    void do_frequency_complete(frequency_analysis const& f) override { events.push_back("cycles " + std::to_string(f.cycles.size())); }
+    void do_allocations_complete(allocation_stats const& stats) override { events.push_back("allocations " + std::to_string(stats.calls)); }
+    void do_benchmark_failure(std::exception_ptr e) override {
+        try {
+            std::rethrow_exception(e);
+        } catch(std::exception const& ex) {
+            events.push_back(std::string("failure: ") + ex.what());
+        }
+    }
+
+    std::vector<std::string> events;
+    int resamples = 0;
+    parameters params;
+};
+
+void write_shard(std::string const& file, int index, std::vector<std::pair<std::size_t, std::string>> const& benchmarks) {
+    shard_plan plan;
+    plan.index = index;
+    plan.count = 2;
+    plan.benchmarks = { "a", "b", "c" };
+    plan.rounds = 1;
+    plan.estimated = fp_seconds::zero();
+    configuration cfg;
+    cfg.samples = 3;
+    cfg.resamples = 42;
+    cfg.output_file = file;
+    raw_reporter rep;
+    rep.configure(cfg);
+    rep.shard_planned(plan);
+    rep.params_start({ { "size", 7 } });
+    for(auto&& b : benchmarks) {
+        rep.benchmark_start(b.second);
+        execution_plan<fp_seconds> samples_plan;
+        samples_plan.iterations_per_sample = 4;
+        samples_plan.estimated_duration = fp_seconds(1);
+        samples_plan.warmup_time = fp_seconds(0);
+        samples_plan.warmup_window = 0;
+        rep.measurement_start(samples_plan);
+        rep.measurement_complete({ fp_seconds(1e-6), fp_seconds(2e-6), fp_seconds(3e-6) });
+        rep.sample_starts_complete({ fp_seconds(0), fp_seconds(1e-3), fp_seconds(2e-3) });
+        resource_usage usage;
+        usage.minor_faults = 5;
+        rep.resource_usage_complete(usage);
+        frequency_analysis frequency;
+        frequency.frequencies = { 3e9, 3e9, 3e9 };
+        rep.frequency_complete(frequency);
+        allocation_stats allocations;
+        allocations.calls = 12;
+        allocations.iterations = 12;
+        rep.allocations_complete(allocations);
+        rep.benchmark_complete();
+    }
+    rep.params_complete();
+    rep.suite_complete();
+}
+
+} // anon namespace
+
+TEST_CASE("merging raw results") {
+    std::string first = "nonius-test-shard1.raw";
+    std::string second = "nonius-test-shard2.raw";
+    write_shard(first, 1, { { 0, "a" }, { 2, "c" } });
+    write_shard(second, 2, { { 1, "b" } });
+
+    configuration cfg;
+    cfg.no_analysis = true;
+    merged_reporter rep;
+
+    std::vector<std::string> measured { "samples 3", "starts 3", "faults 5", "cycles 3", "allocations 12" };
+    auto events = [&](std::vector<std::vector<std::string>> const& benchmarks) {
+        std::vector<std::string> r;
+        for(auto&& b : benchmarks) {
+            r.insert(r.end(), b.begin(), b.end());
+            if(b.size() == 1) r.insert(r.end(), measured.begin(), measured.end());
+        }
+        return r;
+    };
+
+    SECTION("results come back in suite order") {
+        cfg.merge_files = { second, first };
+        merge(cfg, rep);
+        CHECK(rep.events == events({ { "a" }, { "b" }, { "c" } }));
+    }
+
+    SECTION("missing shards are reported") {
+        cfg.merge_files = { first };
+        merge(cfg, rep);
+        CHECK(rep.events == events({ { "a" }, { "b", "failure: no results in any of the merged files" }, { "c" } }));
+    }
+
+    SECTION("analysis settings come from the files") {
+        cfg.merge_files = { first };
+        merge(cfg, rep);
+        CHECK(rep.resamples == 42);
+    }
+
+    SECTION("declared parameters keep their type") {
+        param_registry declared;
+        declared.add("size", 0);
+        auto params = detail::parse_params_key("name=x;size=7", declared.defaults());
+        CHECK(params.at("size").as<int>() == 7);
+        CHECK(params.at("name").as<std::string>() == "x");
+    }
+
+    SECTION("other files are rejected") {
+        cfg.merge_files = { first + ".missing" };
+        CHECK_THROWS_AS(merge(cfg, rep), raw_result_error const&);
+    }
+
+    std::remove(first.c_str());
+    std::remove(second.c_str());
+}
+
+TEST_CASE("sharding with a time budget") {
+    configuration cfg;
+    cfg.shard.index = 1;
+    cfg.shard.count = 2;
+    cfg.time_budget = fp_seconds(1);
+    std::vector<benchmark> benchmarks;
+    merged_reporter rep;
+    CHECK_THROWS_AS(go(cfg, benchmarks.begin(), benchmarks.end(), rep), incompatible_configuration const&);
+}
+
+} // namespace nonius
@@ -0,0 +1,69 @@
+// Nonius - C++ benchmarking tool
+//
+// Written in 2014- by the nonius contributors <nonius@rmf.io>
+//
+// To the extent possible under law, the author(s) have dedicated all copyright and related
+// and neighboring rights to this software to the public domain worldwide. This software is
+// distributed without any warranty.
+//
+// You should have received a copy of the CC0 Public Domain Dedication along with this software.
+// If not, see <http://creativecommons.org/publicdomain/zero/1.0/>
+
+// Tests for static benchmarks
+
+#include <nonius/static_benchmark.h++>
+
+#include "manual_clock.h++"
+
+#include <catch.hpp>
+
+#include <vector>
+
+namespace nonius {
+
+TEST_CASE("static benchmarks") {
+    parameters params;
+    detail::chronometer_model<manual_clock> model;
+
+    SECTION("runs on the concrete clock") {
+        detail::benchmark_function fun = static_benchmark<manual_clock>([] { manual_clock::advance(10); });
+        fun(chronometer(model, 5, params));
+        CHECK(model.elapsed().count() == 50);
+        CHECK(model.direct);
+    }
+
+    SECTION("runs get their index") {
+        std::vector<int> seen;
+        detail::benchmark_function fun = static_benchmark<manual_clock>([&](int i) { seen.push_back(i); });
+        fun(chronometer(model, 3, params));
+        CHECK(seen == (std::vector<int>{ 0, 1, 2 }));
+    }
+
+    SECTION("other clocks use the usual path") {
+        detail::benchmark_function fun = static_benchmark<default_clock>([] { manual_clock::advance(10); });
+        fun(chronometer(model, 5, params));
+        CHECK(model.elapsed().count() == 50);
+        CHECK_FALSE(model.direct);
+    }
+
+    SECTION("the cost of the virtual interface is not subtracted") {
+        environment<FloatDuration<manual_clock>> env;
+        env.clock_cost.mean = FloatDuration<manual_clock>(2);
+        env.function_cost.mean = FloatDuration<manual_clock>(5);
+        CHECK(detail::measurement_overhead(model, env).count() == 7);
+        model.direct = true;
+        CHECK(detail::measurement_overhead(model, env).count() == 2);
+    }
+
+    SECTION("every timed region pays for the clock") {
+        environment<FloatDuration<manual_clock>> env;
+        env.clock_cost.mean = FloatDuration<manual_clock>(2);
+        env.function_cost.mean = FloatDuration<manual_clock>(5);
+        model.start(); model.finish();
+        model.start(); model.finish();
+        model.start(); model.finish();
+        CHECK(detail::measurement_overhead(model, env).count() == 11);
+    }
+}
+
+} // namespace nonius
@@ -0,0 +1,82 @@
+// Nonius - C++ benchmarking tool
+//
+// Written in 2014- by the nonius contributors <nonius@rmf.io>
+//
+// To the extent possible under law, the author(s) have dedicated all copyright and related
+// and neighboring rights to this software to the public domain worldwide. This software is
+// distributed without any warranty.
+//
+// You should have received a copy of the CC0 Public Domain Dedication along with this software.
+// If not, see <http://creativecommons.org/publicdomain/zero/1.0/>
+
+// Tests for steady state detection
+
+#include <nonius/execution_plan.h++>
+
+#include "manual_clock.h++"
+
+#include <catch.hpp>
+
+namespace nonius {
+
+TEST_CASE("steady state detection") {
+    detail::steady_state_detector detector(10);
+
+    SECTION("needs a full window") {
+        for(int i = 0; i < 9; ++i) detector.add(100.);
+        CHECK_FALSE(detector.steady());
+        detector.add(100.);
+        CHECK(detector.steady());
+    }
+
+    SECTION("trends are not steady") {
+        for(int i = 0; i < 10; ++i) detector.add(200. - 5. * i);
+        CHECK_FALSE(detector.steady());
+    }
+
+    SECTION("small trends are ignored") {
+        for(int i = 0; i < 10; ++i) detector.add(1000. - 0.1 * i);
+        CHECK(detector.steady());
+    }
+
+    SECTION("noise without a trend is steady") {
+        for(int i = 0; i < 10; ++i) detector.add(i % 2 == 0 ? 90. : 110.);
+        CHECK(detector.steady());
+    }
+
+    SECTION("changes in spread are not steady") {
+        for(int i = 0; i < 5; ++i) detector.add(100.);
+        for(int i = 0; i < 5; ++i) detector.add(i % 2 == 0 ? 50. : 150.);
+        CHECK_FALSE(detector.steady());
+    }
+
+    SECTION("old timings leave the window") {
+        for(int i = 0; i < 10; ++i) detector.add(1000. - 100. * i);
+        CHECK_FALSE(detector.steady());
+        for(int i = 0; i < 10; ++i) detector.add(100.);
+        CHECK(detector.steady());
+    }
+}
+
+TEST_CASE("steady state warmup") {
+    using duration = FloatDuration<manual_clock>;
+
+    SECTION("settled benchmarks stop after one window") {
+        execution_plan<duration> plan { 1, duration(0), {}, [] { manual_clock::advance(100); }, duration(1e9), 10 };
+        CHECK(plan.warmup<manual_clock>() == 10);
+    }
+
+    SECTION("warmup lasts until timings settle") {
+        int i = 0;
+        execution_plan<duration> plan { 1, duration(0), {}, [&i] { manual_clock::advance(std::max(100, 1000 - 50 * i++)); }, duration(1e9), 10 };
+        CHECK(plan.warmup<manual_clock>() > 20);
+    }
+
+    SECTION("time cap") {
+        int i = 0;
+        execution_plan<duration> plan { 1, duration(0), {}, [&i] { manual_clock::advance(1000 + 10 * i++); }, duration(5000), 10 };
+        CHECK(plan.warmup<manual_clock>() == 5);
+    }
+}
+
+} // namespace nonius
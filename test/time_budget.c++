@@ -0,0 +1,51 @@
+// Nonius - C++ benchmarking tool
+//
+// Written in 2014- by the nonius contributors <nonius@rmf.io>
+//
+// To the extent possible under law, the author(s) have dedicated all copyright and related
+// and neighboring rights to this software to the public domain worldwide. This software is
+// distributed without any warranty.
+//
+// You should have received a copy of the CC0 Public Domain Dedication along with this software.
+// If not, see <http://creativecommons.org/publicdomain/zero/1.0/>
+
+// Tests for the time budget planner
+
+#include <nonius/detail/time_budget.h++>
+
+#include <catch.hpp>
+
+#include <vector>
+
+TEST_CASE("time budget allocation") {
+    using nonius::detail::allocate_budget;
+
+    SECTION("everything fits") {
+        auto a = allocate_budget({ 0.01, 0.02 }, { 0.1, 0.1 }, 10., 100, 10);
+        CHECK(a.samples == 100);
+        CHECK(a.skipped == (std::vector<bool>{ false, false }));
+    }
+
+    SECTION("samples are lowered to fit") {
+        auto a = allocate_budget({ 0.01, 0.03 }, { 0.5, 0.5 }, 3., 100, 10);
+        CHECK(a.samples == 50);
+        CHECK(a.skipped == (std::vector<bool>{ false, false }));
+    }
+
+    SECTION("the most expensive benchmarks are skipped") {
+        auto a = allocate_budget({ 0.01, 1., 0.02, 0.5 }, { 0., 0., 0., 0. }, 2., 100, 10);
+        CHECK(a.samples == 66);
+        CHECK(a.skipped == (std::vector<bool>{ false, true, false, true }));
+    }
+
+    SECTION("nothing fits") {
+        auto a = allocate_budget({ 1., 2. }, { 0., 0. }, 1., 100, 10);
+        CHECK(a.skipped == (std::vector<bool>{ true, true }));
+    }
+
+    SECTION("minimum is capped by the requested samples") {
+        auto a = allocate_budget({ 1. }, { 0. }, 7., 5, 10);
+        CHECK(a.samples == 5);
+        CHECK(a.skipped == (std::vector<bool>{ false }));
+    }
+}
@@ -76,4 +76,29 @@ def customise_build(tools, ninja):
     ninja.build('examples', 'phony',
                 inputs = examples)
 
+    # allocation tracking replaces the global operator new, so it is tested on its own
+    allocation_test = path.join('test', 'allocation.c++')
+    allocation_obj = path.join('obj', 'allocation-test', 'allocation.o')
+    ninja.build(allocation_obj, 'cxx',
+            inputs = allocation_test,
+            variables = { 'extraflags': '-DNONIUS_TEST_ALLOCATIONS' },
+            order_only = 'templates')
+    allocation_runner = path.join('bin', tools.program_name('allocation-test'))
+    ninja.build(allocation_runner, 'link',
+            inputs = [allocation_obj, vallus.object_file(path.join('test', 'runner.c++'))])
+    ninja.build('allocation-test', 'phony',
+            inputs = allocation_runner)
+
+    merge_file = path.join('tools', 'nonius-merge.c++')
+    ninja.build(vallus.object_file(merge_file), 'cxx',
+            inputs = merge_file,
+            implicit = path.join('dist', 'nonius.h++'),
+            variables = { 'extraflags': tools.include('dist') },
+            order_only = 'templates')
+    merge = path.join('bin', tools.program_name('nonius-merge'))
+    ninja.build(merge, 'link',
+            inputs = [vallus.object_file(merge_file)])
+    ninja.build('nonius-merge', 'phony',
+            inputs = merge)
+
 v.bootstrap(default = 'header', custom = customise_build)
@@ -0,0 +1,17 @@
+// Nonius - C++ benchmarking tool
+//
+// Written in 2014- by the nonius contributors <nonius@rmf.io>
+//
+// To the extent possible under law, the author(s) have dedicated all copyright and related
+// and neighboring rights to this software to the public domain worldwide. This software is
+// distributed without any warranty.
+//
+// You should have received a copy of the CC0 Public Domain Dedication along with this software.
+// If not, see <http://creativecommons.org/publicdomain/zero/1.0/>
+
+// A runner without benchmarks, for merging the raw results of shards run elsewhere:
+//
+//     nonius-merge -m shard1.raw -m shard2.raw -r html -o report.html
+
+#define NONIUS_RUNNER
+#include <nonius.h++>
@@ -31,7 +31,9 @@ ifParser = re.compile( r'\s*#ifndef NONIUS_.*HPP')
 endIfParser = re.compile( r'\s*#endif // NONIUS_.*_HPP')
 ifImplParser = re.compile( r'\s*#if.*(NONIUS_RUNNER)')
 commentParser1 = re.compile( r'^\s*/\*')
-commentParser2 = re.compile( r'^\s*\*')
+# Continuation lines of block comments. A '*' followed by anything else starts a statement,
+# like `*out++ = c;` in format_number.h++ or `*this = ...` in param.h++, and must be kept.
+commentParser2 = re.compile( r'^\s*\*(\s|/|\*|$)')
 blankParser = re.compile( r'^\s*$')
 seenHeaders = set([])
 
@@ -12,6 +12,9 @@
 # If not, see <http://creativecommons.org/publicdomain/zero/1.0/>
 
 # Script for making C++ strings out of text files
+#
+# The output is a list of { text, hole } initializers. Text is split into pieces short enough
+# for any compiler, and every {$name} in the input becomes a hole for the program to fill in.
 
 import sys
 import os
@@ -25,6 +28,8 @@ outfile = sys.argv[2]
 
 max_len = 10000
 
+hole_pattern = re.compile(r'\{\$([a-z_]+)\}')
+
 def split_len(s, length):
     return [s[i:i+length] for i in range(0, len(s), length)]
 
@@ -32,14 +37,24 @@ def stringize(s):
     s = s.replace('\\', '\\\\').replace('"', '\\"').replace('\n', '\\n')
     return '"' + s + '"\n'
 
-with open(infile, 'r') as src, open(outfile, 'w') as dst:
+def write_text(dst, text):
     length = 0
-    for line in src:
+    dst.write('{ ')
+    for line in text.splitlines(True):
         for piece in split_len(line, max_len):
             stringized = stringize(piece)
             length += len(stringized)
-            if length > max_len:
-                dst.write(',\n')
+            if length > max_len and length > len(stringized):
+                dst.write(', "" },\n{ ')
                 length = len(stringized)
             dst.write(stringized)
+    dst.write(', "" },\n')
 
+with open(infile, 'r') as src, open(outfile, 'w') as dst:
+    parts = hole_pattern.split(src.read())
+    for i, part in enumerate(parts):
+        if i % 2 == 0:
+            if part:
+                write_text(dst, part)
+        else:
+            dst.write('{ "", "' + part + '" },\n')
@@ -13,18 +13,13 @@
        <span class="arr"></span>
        <select id="chooser">
          <option value="summary">summary</option>
-         {% for run in runs %}
-         <option value="{$loop.index0}">samples
-           {% for param in run.params %}
-           | {$param.name}={$param.value}
-           {% endfor %}
-         </option>
-         {% endfor %}
+         {$options}
        </select>
      </div>
    </div>
    <div id="plot"></div>
    <div id="footer">Generated with <a href="http://flamingdangerzone.com/nonius">nonius</a></div>
+   {$samples}
    <script type="text/javascript"> {% include "report.tpl.js" %} </script>
  </body>
 </html>
@@ -1,28 +1,8 @@
 !function () {
-    var data = {
-        title: '{$title}',
-        units: '{$units}',
-        logarithmic: {$logarithmic},
-        param: '{$runparam}',
-        runs: [
-            {% for run in runs %}{
-                params: {
-                    {% for param in run.params %}'{$param.name}': '{$param.value}',
-                    {% endfor %}
-                },
-                benchmarks: [
-                    {% for benchmark in run.benchmarks %}{
-                        name: '{$benchmark.name}',
-                        mean: {$benchmark.mean},
-                        stddev: {$benchmark.stddev},
-                        samples: [
-                            {% for sample in benchmark.samples %}{$sample}, {% endfor %}
-                        ],
-                    },{% endfor %}
-                ]
-            },{% endfor %}
-        ]
-    };
+    // { title, units, logarithmic, param, compressed, runs: [{ params: { name: value }, benchmarks: [{ name, failed, mean, stddev, count, startcount }] }] }
+    // The samples and starts of each run are only decoded from its #samplesN element when it is plotted.
+    // Failed benchmarks keep their place in every run, with no samples, and are left out of the plots.
+    var data = {$data};
 
     var plotdiv = document.getElementById("plot");
     window.addEventListener("resize", function() {
@@ -48,14 +28,53 @@
             } else {
                 plotSingleSummary();
             }
+        } else if (plot[0] == 't') {
+            loadRun(plot.substr(1), function () { if (chooser.value == plot) plotTimeSeries(plot.substr(1)); });
         } else {
-            plotSamples(plot);
+            loadRun(plot, function () { if (chooser.value == plot) plotSamples(plot); });
         }
     }
 
+    function loadRun(index, done) {
+        var run = data.runs[index];
+        if (run.loaded) return done();
+        var text = atob(document.getElementById('samples' + index).textContent);
+        var bytes = new Uint8Array(text.length);
+        for (var i = 0; i < text.length; ++i) {
+            bytes[i] = text.charCodeAt(i);
+        }
+        var unpack = function (buffer) {
+            var view = new DataView(buffer);
+            var offset = 0;
+            var floats = function (n) {
+                var a = new Array(n);
+                for (var i = 0; i < n; ++i, offset += 4) {
+                    a[i] = view.getFloat32(offset, true);
+                }
+                return a;
+            };
+            run.benchmarks.forEach(function (b) {
+                b.samples = floats(b.count);
+                b.starts = floats(b.startcount);
+            });
+            run.loaded = true;
+            done();
+        };
+        if (data.compressed) {
+            var inflated = new Blob([bytes]).stream().pipeThrough(new DecompressionStream('deflate'));
+            new Response(inflated).arrayBuffer().then(unpack);
+        } else {
+            unpack(bytes.buffer);
+        }
+    }
+
+    function working(traces, b) {
+        return traces.filter(function (_, i) { return !b[i].failed; });
+    }
+
     function plotSamples(plot) {
         var run = data.runs[plot];
-        var traces = run.benchmarks.map(function (b, i) {
+        var traces = working(run.benchmarks.map(function (b, i) {
             return {
                 name: b.name,
                 type: 'scatter',
@@ -64,7 +83,7 @@
                 y: b.samples,
                 x: b.samples.map(function (_, i) { return i; })
             }
-        });
+        }), run.benchmarks);
         var layout = {
             title: data.title,
             showLegend: true,
@@ -79,6 +98,32 @@
         Plotly.newPlot(plotdiv, traces, layout);
     }
 
+    function plotTimeSeries(plot) {
+        var run = data.runs[plot];
+        var traces = working(run.benchmarks.map(function (b, i) {
+            return {
+                name: b.name,
+                type: 'scatter',
+                mode: 'lines+markers',
+                marker: { symbol: i },
+                y: b.samples,
+                x: b.starts
+            }
+        }), run.benchmarks);
+        var layout = {
+            title: data.title,
+            showLegend: true,
+            xaxis: { title: 'Time since the first sample (ms)' },
+            yaxis: {
+                title: 'Time (' + data.units + ')',
+                rangemode: 'tozero',
+                zeroline: true
+            },
+            legend: legendStyle
+        };
+        Plotly.newPlot(plotdiv, traces, layout);
+    }
+
     function plotSummary() {
         var traces = data.runs[0].benchmarks.map(function (b, i) {
             return {
@@ -86,10 +131,10 @@
                 type: 'scatter',
                 marker: { symbol: i },
                 x: data.runs.map(function (r) { return r.params[data.param]; }),
-                y: data.runs.map(function (r) { return r.benchmarks[i].mean; }),
+                y: data.runs.map(function (r) { return r.benchmarks[i].failed ? null : r.benchmarks[i].mean; }),
                 error_y: {
                     type: 'data',
-                    array: data.runs.map(function (r) { return r.benchmarks[i].stddev; }),
+                    array: data.runs.map(function (r) { return r.benchmarks[i].failed ? null : r.benchmarks[i].stddev; }),
                     visible: true
                 }
             }
@@ -113,7 +158,7 @@
     }
 
     function plotSingleSummary() {
-        var traces = data.runs[0].benchmarks.map(function (b, i) {
+        var traces = working(data.runs[0].benchmarks.map(function (b, i) {
             return {
                 type: 'bar',
                 name: b.name,
@@ -125,7 +170,7 @@
                     visible: true
                 }
             }
-        });
+        }), data.runs[0].benchmarks);
         var layout = {
             title: data.title,
             showLegend: true,